@@ -0,0 +1,220 @@
+/**
+ * @file csvTokenizer.c
+ * @author Pedro Vitória
+ * @brief Provides the vectorized and scalar implementations of the line tokenizer.
+ */
+
+#include "csvTokenizer.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOKENIZER_X86
+#endif
+
+/**
+ * @brief Holds the state of the line being tokenized.
+ * 
+ */
+typedef struct lineTokens
+{
+    const char *fieldStart;
+    Field *fields;
+    int maxFields;
+    int count;
+} LineTokens;
+
+/**
+ * @brief Closes the current field at a given position and opens the next one right after it.
+ * 
+ * @param tokens [in] The state of the line
+ * @param position [in] The position of the delimiter (or the end of the line) that closes the field
+ */
+static void closeField(LineTokens *tokens, const char *position)
+{
+    if (tokens->count < tokens->maxFields)
+    {
+        tokens->fields[tokens->count].start = tokens->fieldStart;
+        tokens->fields[tokens->count].length = position - tokens->fieldStart;
+    }
+    tokens->count++;
+    tokens->fieldStart = position + 1;
+}
+
+/**
+ * @brief Closes the last field of the line and pads the missing fields.
+ * 
+ * @param tokens [in] The state of the line
+ * @param lineEnd [in] The position of the line terminator, or the end of the buffer
+ * @param fieldCount [out] The number of fields found in the line
+ */
+static void closeLine(LineTokens *tokens, const char *lineEnd, int *fieldCount)
+{
+    if (lineEnd > tokens->fieldStart && lineEnd[-1] == '\r')
+        lineEnd--;
+    closeField(tokens, lineEnd);
+
+    for (int i = tokens->count; i < tokens->maxFields; i++)
+    {
+        tokens->fields[i].start = lineEnd;
+        tokens->fields[i].length = 0;
+    }
+    *fieldCount = tokens->count;
+}
+
+/**
+ * @brief Scans the bytes in [position, end[ one at a time.
+ * 
+ * @param tokens [in] The state of the line
+ * @param position [in] Where to start scanning
+ * @param end [in] The end of the buffer
+ * @param delim [in] The field delimiter
+ * @param fieldCount [out] The number of fields found in the line
+ * @return The beginning of the next line, or <b>end</b> if there is none
+ */
+static const char *scanScalar(LineTokens *tokens, const char *position, const char *end, char delim, int *fieldCount)
+{
+    for (; position < end; position++)
+    {
+        if (*position == '\n')
+        {
+            closeLine(tokens, position, fieldCount);
+            return position + 1;
+        }
+        if (*position == delim)
+            closeField(tokens, position);
+    }
+    closeLine(tokens, end, fieldCount);
+    return end;
+}
+
+/**
+ * @brief Handles the delimiters and line terminator flagged in a mask of matches.
+ * 
+ * @param tokens [in] The state of the line
+ * @param block [in] The beginning of the block the mask refers to
+ * @param mask [in] One bit per byte of the block, set for the delimiters and line terminators
+ * @return The position of the line terminator, or NULL if the block doesn't contain one
+ */
+static const char *consumeMask(LineTokens *tokens, const char *block, unsigned int mask)
+{
+    while (mask != 0)
+    {
+        const char *position = block + __builtin_ctz(mask);
+        if (*position == '\n')
+            return position;
+        closeField(tokens, position);
+        mask &= mask - 1;
+    }
+    return NULL;
+}
+
+#ifdef TOKENIZER_X86
+/**
+ * @brief Scans the line 16 bytes at a time with SSE2, finishing the last partial block with scanScalar.
+ * 
+ * @param tokens [in] The state of the line
+ * @param position [in] Where to start scanning
+ * @param end [in] The end of the buffer
+ * @param delim [in] The field delimiter
+ * @param fieldCount [out] The number of fields found in the line
+ * @return The beginning of the next line, or <b>end</b> if there is none
+ */
+__attribute__((target("sse2"))) static const char *scanSSE2(LineTokens *tokens, const char *position, const char *end, char delim, int *fieldCount)
+{
+    const __m128i delimiters = _mm_set1_epi8(delim);
+    const __m128i newlines = _mm_set1_epi8('\n');
+
+    for (; end - position >= 16; position += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)position);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters), _mm_cmpeq_epi8(block, newlines)));
+
+        const char *lineEnd = consumeMask(tokens, position, mask);
+        if (lineEnd != NULL)
+        {
+            closeLine(tokens, lineEnd, fieldCount);
+            return lineEnd + 1;
+        }
+    }
+    return scanScalar(tokens, position, end, delim, fieldCount);
+}
+
+/**
+ * @brief Scans the line 32 bytes at a time with AVX2, finishing the last partial block with scanSSE2.
+ * 
+ * @param tokens [in] The state of the line
+ * @param position [in] Where to start scanning
+ * @param end [in] The end of the buffer
+ * @param delim [in] The field delimiter
+ * @param fieldCount [out] The number of fields found in the line
+ * @return The beginning of the next line, or <b>end</b> if there is none
+ */
+__attribute__((target("avx2"))) static const char *scanAVX2(LineTokens *tokens, const char *position, const char *end, char delim, int *fieldCount)
+{
+    const __m256i delimiters = _mm256_set1_epi8(delim);
+    const __m256i newlines = _mm256_set1_epi8('\n');
+
+    for (; end - position >= 32; position += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)position);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, delimiters), _mm256_cmpeq_epi8(block, newlines)));
+
+        const char *lineEnd = consumeMask(tokens, position, mask);
+        if (lineEnd != NULL)
+        {
+            closeLine(tokens, lineEnd, fieldCount);
+            return lineEnd + 1;
+        }
+    }
+    return scanSSE2(tokens, position, end, delim, fieldCount);
+}
+#endif
+
+/** The scanners, indexed by CSV_SCANNER_SCALAR, CSV_SCANNER_SSE2 and CSV_SCANNER_AVX2. Those the build can't provide fall back to scanScalar. */
+#ifdef TOKENIZER_X86
+static const char *(*const scanners[CSV_SCANNERS])(LineTokens *, const char *, const char *, char, int *) = {scanScalar, scanSSE2, scanAVX2};
+#else
+static const char *(*const scanners[CSV_SCANNERS])(LineTokens *, const char *, const char *, char, int *) = {scanScalar, scanScalar, scanScalar};
+#endif
+
+/** The widest scanner supported by the processor, picked by selectScanner. */
+static int bestScanner = CSV_SCANNER_SCALAR;
+static pthread_once_t scannerSelected = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Picks the widest scanner supported by the processor.
+ * 
+ */
+static void selectScanner(void)
+{
+#ifdef TOKENIZER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        bestScanner = CSV_SCANNER_AVX2;
+    else if (__builtin_cpu_supports("sse2"))
+        bestScanner = CSV_SCANNER_SSE2;
+#endif
+}
+
+int csvBestScanner(void)
+{
+    pthread_once(&scannerSelected, selectScanner);
+    return bestScanner;
+}
+
+bool csvScannerSupported(int scanner)
+{
+    return scanner >= CSV_SCANNER_SCALAR && scanner <= csvBestScanner();
+}
+
+const char *tokenizeLine(int scanner, const char *cursor, const char *end, char delim, Field fields[], int maxFields, int *fieldCount)
+{
+    LineTokens tokens;
+    tokens.fieldStart = cursor;
+    tokens.fields = fields;
+    tokens.maxFields = maxFields;
+    tokens.count = 0;
+
+    return scanners[scanner](&tokens, cursor, end, delim, fieldCount);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file csvTokenizer.h
+ * @author Pedro Vitória
+ * @brief Defines the tokenizer used to split the lines of the patients' and regions' files into fields.
+ * <br>The tokenizer looks for the field delimiter and the line terminator 32 bytes at a time with AVX2 or 16 bytes at a time with SSE2,
+ * picked at runtime according to the processor, and falls back to a scalar loop elsewhere.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#define CSV_SCANNER_SCALAR 0
+#define CSV_SCANNER_SSE2 1
+#define CSV_SCANNER_AVX2 2
+
+/** The number of scanners a line can be tokenized with. */
+#define CSV_SCANNERS 3
+
+/**
+ * @brief Represents a single field of a delimited line.
+ * <br>The field is not null-terminated: its characters are the <b>length</b> characters that begin at <b>start</b>.
+ * 
+ */
+typedef struct field
+{
+    const char *start;
+    int length;
+} Field;
+
+/**
+ * @brief Picks the widest scanner supported by the processor. The processor is only queried on the first call.
+ * <br>A file is tokenized with the scanner picked once before its first line, rather than once per line.
+ * 
+ * @return CSV_SCANNER_AVX2, CSV_SCANNER_SSE2 or CSV_SCANNER_SCALAR
+ */
+int csvBestScanner(void);
+
+/**
+ * @brief Checks if the processor supports a scanner.
+ * 
+ * @param scanner [in] CSV_SCANNER_SCALAR, CSV_SCANNER_SSE2 or CSV_SCANNER_AVX2
+ * @return true if lines can be tokenized with the scanner or,
+ * @return false otherwise
+ */
+bool csvScannerSupported(int scanner);
+
+/**
+ * @brief Splits the line that begins at a given position of a buffer into fields, without modifying or copying it.
+ * <br>Every scanner splits a line into the same fields; they only differ in how many bytes they compare at a time.
+ * <br>At most <b>maxFields</b> fields are stored. Fields missing from the line are stored as empty fields and fields beyond <b>maxFields</b> are only counted,
+ * so the returned count can be checked against the expected number of fields.
+ * The line terminator ("\n" or "\r\n") is not part of the last field.
+ * 
+ * @param scanner [in] The scanner to use, which the processor must support (see csvBestScanner)
+ * @param cursor [in] The beginning of the line
+ * @param end [in] The end of the buffer
+ * @param delim [in] The field delimiter
+ * @param fields [out] The fields of the line
+ * @param maxFields [in] The capacity of <b>fields</b>
+ * @param fieldCount [out] The number of fields found in the line. An empty line has a single empty field
+ * @return The beginning of the next line, or <b>end</b> if there is none
+ */
+const char *tokenizeLine(int scanner, const char *cursor, const char *end, char delim, Field fields[], int maxFields, int *fieldCount);
@@ -0,0 +1,70 @@
+/**
+ * @file dailySeries.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>DailySeries</i></b> data type
+ */
+
+#include "dailySeries.h"
+#include <limits.h>
+
+bool dailySeriesBuild(DailySeries *series, const int confirmedDays[], const int releasedDays[], const int deceasedDays[], int size, DatasetArena *arena)
+{
+    const int *days[DAILY_EVENTS] = {confirmedDays, releasedDays, deceasedDays};
+
+    //The series spans from the earliest to the latest known date, of any kind.
+    int firstDay = INT_MAX, lastDay = 0;
+    for (int e = 0; e < DAILY_EVENTS; e++)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            if (days[e][i] <= 0)
+                continue;
+            if (days[e][i] < firstDay)
+                firstDay = days[e][i];
+            if (days[e][i] > lastDay)
+                lastDay = days[e][i];
+        }
+    }
+    if (lastDay == 0)
+        firstDay = 1;
+
+    series->firstDay = firstDay;
+    series->dayCount = lastDay >= firstDay ? lastDay - firstDay + 1 : 0;
+
+    size_t entries = (size_t)series->dayCount + 1;
+    datasetArenaReserve(arena, DAILY_EVENTS * (entries * sizeof(int) + DATASET_ARENA_ALIGNMENT - 1));
+    for (int e = 0; e < DAILY_EVENTS; e++)
+    {
+        int *cumulative = datasetArenaAlloc(arena, entries * sizeof(int));
+        series->cumulative[e] = cumulative;
+        if (cumulative == NULL)
+            return false;
+
+        //Count the events of each day one position ahead, then add up the counts into prefix sums.
+        for (size_t d = 0; d < entries; d++)
+            cumulative[d] = 0;
+        for (int i = 0; i < size; i++)
+        {
+            if (days[e][i] > 0)
+                cumulative[days[e][i] - firstDay + 1]++;
+        }
+        for (size_t d = 1; d < entries; d++)
+            cumulative[d] += cumulative[d - 1];
+    }
+    return true;
+}
+
+int dailySeriesCount(const DailySeries *series, int event, int firstDay, int lastDay)
+{
+    int first = firstDay - series->firstDay;
+    int last = lastDay - series->firstDay;
+
+    if (first < 0)
+        first = 0;
+    if (last >= series->dayCount)
+        last = series->dayCount - 1;
+    if (first > last)
+        return 0;
+
+    return series->cumulative[event][last + 1] - series->cumulative[event][first];
+}
@@ -0,0 +1,55 @@
+/**
+ * @file dailySeries.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>DailySeries</i></b> and related operations.
+ * <br>A daily series counts, for each day between the first and the last known date of the data, the patients confirmed, released and deceased on that day.
+ * The counts are kept as prefix sums, so the number of events over any range of days takes constant time to retrieve.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "datasetArena.h"
+
+#define DAILY_CONFIRMED 0
+#define DAILY_RELEASED 1
+#define DAILY_DECEASED 2
+
+/** The number of kinds of events counted by a daily series. */
+#define DAILY_EVENTS 3
+
+/**
+ * @brief Represents a daily series.
+ * 
+ */
+typedef struct dailySeries
+{
+    int firstDay; //Epoch day of the first day of the series
+    int dayCount;
+    int *cumulative[DAILY_EVENTS]; //dayCount + 1 prefix sums per event: cumulative[e][i] counts the events before the day firstDay + i
+} DailySeries;
+
+/**
+ * @brief Builds the daily series of the dates of a set of patients. Unknown dates (epoch day 0) aren't counted.
+ * 
+ * @param series [out] The series
+ * @param confirmedDays [in] The epoch day each patient was confirmed
+ * @param releasedDays [in] The epoch day each patient was released
+ * @param deceasedDays [in] The epoch day each patient deceased
+ * @param size [in] The number of patients
+ * @param arena [in] The arena that will hold the arrays of the series
+ * @return true if the series was successfully built or,
+ * @return false if insufficient memory for allocation
+ */
+bool dailySeriesBuild(DailySeries *series, const int confirmedDays[], const int releasedDays[], const int deceasedDays[], int size, DatasetArena *arena);
+
+/**
+ * @brief Retrieves the number of events of a kind between two days, both included. Days outside the series have no events.
+ * 
+ * @param series [in] The series
+ * @param event [in] The kind of event: DAILY_CONFIRMED, DAILY_RELEASED or DAILY_DECEASED
+ * @param firstDay [in] The epoch day of the first day of the range
+ * @param lastDay [in] The epoch day of the last day of the range
+ * @return The number of events in the range, 0 if the range is empty
+ */
+int dailySeriesCount(const DailySeries *series, int event, int firstDay, int lastDay);
@@ -0,0 +1,102 @@
+/**
+ * @file datasetArena.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>DatasetArena</i></b> data type
+ */
+
+#include "datasetArena.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+struct arenaBlock
+{
+    struct arenaBlock *next;
+    size_t size; //Bytes available after the header
+    size_t used;
+};
+
+/**
+ * @brief Rounds a size up to a multiple of DATASET_ARENA_ALIGNMENT.
+ * 
+ * @param size [in] A size in bytes
+ * @return The rounded size
+ */
+static size_t alignSize(size_t size)
+{
+    return (size + DATASET_ARENA_ALIGNMENT - 1) & ~(size_t)(DATASET_ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Finds the first aligned address at or after the free space of a block.
+ * 
+ * @param block [in] A block
+ * @return The offset of the address from the beginning of the free space of the block
+ */
+static size_t alignmentPadding(struct arenaBlock *block)
+{
+    uintptr_t next = (uintptr_t)(block + 1) + block->used;
+    return alignSize(next) - next;
+}
+
+/**
+ * @brief Obtains a new block from the system, which becomes the block allocations are served from.
+ * 
+ * @param arena [in] The arena
+ * @param size [in] The minimum number of usable bytes of the block
+ * @return true if the block was obtained or,
+ * @return false if insufficient memory for allocation
+ */
+static bool addBlock(DatasetArena *arena, size_t size)
+{
+    if (size < DATASET_ARENA_BLOCK_SIZE)
+        size = DATASET_ARENA_BLOCK_SIZE;
+
+    struct arenaBlock *block = (struct arenaBlock *)malloc(sizeof(struct arenaBlock) + size);
+    if (block == NULL)
+        return false;
+
+    block->next = arena->blocks;
+    block->size = size;
+    block->used = 0;
+    arena->blocks = block;
+    arena->reserved += size;
+    return true;
+}
+
+bool datasetArenaReserve(DatasetArena *arena, size_t size)
+{
+    struct arenaBlock *block = arena->blocks;
+    if (block != NULL && block->size - block->used >= size)
+        return true;
+
+    return addBlock(arena, size);
+}
+
+void *datasetArenaAlloc(DatasetArena *arena, size_t size)
+{
+    struct arenaBlock *block = arena->blocks;
+    if (block == NULL || block->size - block->used < alignmentPadding(block) + size)
+    {
+        if (!addBlock(arena, size + DATASET_ARENA_ALIGNMENT - 1))
+            return NULL;
+        block = arena->blocks;
+    }
+
+    size_t padding = alignmentPadding(block);
+    void *memory = (char *)(block + 1) + block->used + padding;
+    block->used += padding + size;
+    arena->allocated += padding + size;
+    return memory;
+}
+
+void datasetArenaRelease(DatasetArena *arena)
+{
+    while (arena->blocks != NULL)
+    {
+        struct arenaBlock *next = arena->blocks->next;
+        free(arena->blocks);
+        arena->blocks = next;
+    }
+    arena->allocated = 0;
+    arena->reserved = 0;
+}
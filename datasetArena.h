@@ -0,0 +1,61 @@
+/**
+ * @file datasetArena.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>DatasetArena</i></b> and related operations.
+ * A dataset arena owns the memory of one loaded generation of data: allocations are carved in order out of a few large blocks,
+ * are never freed individually, and are all released at once when the data is cleared or reloaded.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** The minimum size, in bytes, of the blocks an arena obtains from the system. */
+#define DATASET_ARENA_BLOCK_SIZE (1 << 20)
+
+/** The alignment, in bytes, of every allocation. A cache line, which also suits vector loads. */
+#define DATASET_ARENA_ALIGNMENT 64
+
+/** Block of memory of an arena. */
+struct arenaBlock;
+
+/**
+ * @brief Represents a dataset arena. Zero-initialize before use.
+ * <br>Since nothing is freed before the arena is released, <b>allocated</b> is also the high-water mark of the memory used by the dataset.
+ * 
+ */
+typedef struct datasetArena
+{
+    struct arenaBlock *blocks; //Most recent block first
+    size_t allocated;          //Bytes handed out, including alignment padding
+    size_t reserved;           //Bytes obtained from the system
+} DatasetArena;
+
+/**
+ * @brief Makes sure the next allocations, totalling up to a given size, are served from a single block.
+ * <br>Used when the size of a dataset is known in advance, so that it takes a single allocation from the system.
+ * 
+ * @param arena [in] The arena
+ * @param size [in] The number of bytes about to be allocated, counting DATASET_ARENA_ALIGNMENT - 1 bytes of padding per allocation
+ * @return true if the memory is available or,
+ * @return false if insufficient memory for allocation
+ */
+bool datasetArenaReserve(DatasetArena *arena, size_t size);
+
+/**
+ * @brief Allocates memory from an arena, aligned to DATASET_ARENA_ALIGNMENT bytes.
+ * 
+ * @param arena [in] The arena
+ * @param size [in] The number of bytes to allocate
+ * @return A pointer to the memory, valid until the arena is released, or
+ * @return NULL if insufficient memory for allocation
+ */
+void *datasetArenaAlloc(DatasetArena *arena, size_t size);
+
+/**
+ * @brief Releases all the memory of an arena at once, leaving it empty and ready for reuse.
+ * 
+ * @param arena [in] The arena
+ */
+void datasetArenaRelease(DatasetArena *arena);
@@ -7,15 +7,45 @@
 #include "date.h"
 #include <stdio.h>
 
+int dateEpochDay(unsigned int day, unsigned int month, unsigned int year)
+{
+    //Number of days in the year before the first day of each month, ignoring leap days.
+    static const int daysBeforeMonth[13] = {0, 0, 31, 59, 90, 120, 151,
+                                            181, 212, 243, 273, 304, 334};
+
+    //Leap days are counted up to the previous year if the date is not past February.
+    int years = (int)year - (month <= 2 ? 1 : 0);
+    int leapDays = years / 4 - years / 100 + years / 400;
+
+    return (int)year * 365 + (int)day + (month <= 12 ? daysBeforeMonth[month] : 0) + leapDays;
+}
+
 Date dateCreate(unsigned int day, unsigned int month, unsigned int year)
 {
     Date date;
     date.day = day;
     date.month = month;
     date.year = year;
+    date.epochDay = dateEpochDay(day, month, year);
     return date;
 }
 
+Date dateFromEpochDay(int epochDay)
+{
+    //Start from an estimate of the year, using the average length of a year, and correct it.
+    unsigned int year = (unsigned int)((long long)epochDay * 400 / 146097);
+    while (dateEpochDay(1, 1, year + 1) <= epochDay)
+        year++;
+    while (year > 0 && dateEpochDay(1, 1, year) > epochDay)
+        year--;
+
+    unsigned int month = 12;
+    while (month > 1 && dateEpochDay(1, month, year) > epochDay)
+        month--;
+
+    return dateCreate(epochDay - dateEpochDay(1, month, year) + 1, month, year);
+}
+
 void datePrint(Date date)
 {
     printf("%02d/%02d/%d", date.day, date.month, date.year);
@@ -23,5 +53,10 @@ void datePrint(Date date)
 
 bool dateEquals(Date date1, Date date2)
 {
-    return (date1.day == date2.day && date1.month == date2.month && date1.year == date2.year);
+    return date1.epochDay == date2.epochDay;
+}
+
+int dateCompare(Date date1, Date date2)
+{
+    return date1.epochDay - date2.epochDay;
 }
\ No newline at end of file
@@ -10,11 +10,14 @@
 
 /**
  * @brief Represents a date (DD/MM/YYYY).
+ * <br>Besides its calendar fields, a date holds the number of days elapsed since the beginning of the calendar (its epoch day).
+ * The epoch day is computed once, when the date is created, so that dates can be compared and subtracted with a single integer operation.
  * 
  */
 typedef struct date
 {
     unsigned int day, month, year;
+    int epochDay;
 } Date;
 
 /**
@@ -27,6 +30,25 @@ typedef struct date
  */
 Date dateCreate(unsigned int day, unsigned int month, unsigned int year);
 
+/**
+ * @brief Computes the epoch day of a given date: the number of days elapsed since the beginning of the calendar.
+ * <br>Unknown dates (00/00/0000) have an epoch day of 0, which precedes every valid date.
+ * 
+ * @param day [in] The day
+ * @param month [in] The month
+ * @param year [in] The year
+ * @return The epoch day of the date
+ */
+int dateEpochDay(unsigned int day, unsigned int month, unsigned int year);
+
+/**
+ * @brief Returns the date of a given epoch day. This is the inverse of dateEpochDay, for valid dates.
+ * 
+ * @param epochDay [in] The epoch day, greater than 0
+ * @return Date The date whose epoch day is 'epochDay'
+ */
+Date dateFromEpochDay(int epochDay);
+
 /**
  * @brief Prints a textual representation of a given Date.
  * 
@@ -42,4 +64,15 @@ void datePrint(Date date);
  * @return true If the dates are equal or,
  * @return false If the dates are different
  */
-bool dateEquals(Date date1, Date date2);
\ No newline at end of file
+bool dateEquals(Date date1, Date date2);
+
+/**
+ * @brief Compares two dates chronologically.
+ * 
+ * @param date1 The first date
+ * @param date2 The second date
+ * @return 0 if the dates are equal, or
+ * @return > 0 if date1 is after date2, or
+ * @return < 0 if date1 is before date2
+ */
+int dateCompare(Date date1, Date date2);
@@ -0,0 +1,192 @@
+/**
+ * @file dictionary.c
+ * 
+ * @brief Provides an implementation of the ADT Dictionary with an
+ * open-addressing hash table (linear probing) over a single buffer
+ * holding every interned string.
+ * 
+ * @author Pedro Vitória
+ * @bug No known bugs.
+ */
+
+#include "dictionary.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct dictionaryImpl
+{
+	char *characters;		/* every string, null-terminated, one after the other */
+	int charactersSize;
+	int charactersCapacity;
+
+	int *offsets;			/* code -> position of the string in 'characters' */
+	unsigned int *hashes;	/* code -> hash of the string */
+	int size;
+	int capacity;
+
+	int *slots;				/* hash table of codes, -1 marks an empty slot */
+	int slotCount;			/* always a power of two, at least twice 'capacity' */
+} DictionaryImpl;
+
+/**
+ * @brief Auxiliary function to hash a string (FNV-1a).
+ * 
+ * @param text [in] the characters of the string
+ * @param length [in] the number of characters
+ * @return the hash of the string
+ */
+static unsigned int hashString(const char *text, int length) {
+	unsigned int hash = 2166136261u;
+	for (int i = 0; i < length; i++) {
+		hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Auxiliary function to find the slot of a string.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * @param text [in] the characters of the string
+ * @param length [in] the number of characters
+ * @param hash [in] the hash of the string
+ * @return the slot holding the string's code, or
+ * @return the empty slot where the string's code would be placed
+ */
+static int findSlot(PtDictionary dictionary, const char *text, int length, unsigned int hash) {
+	int mask = dictionary->slotCount - 1;
+	int slot = hash & mask;
+
+	while (dictionary->slots[slot] != -1) {
+		int code = dictionary->slots[slot];
+		const char *candidate = dictionary->characters + dictionary->offsets[code];
+		if (dictionary->hashes[code] == hash && memcmp(candidate, text, length) == 0 && candidate[length] == '\0')
+			return slot;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+/**
+ * @brief Auxiliary function to grow the arrays indexed by code and the hash table.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * @return true if there's room for one more code, or
+ * @return false if unsufficient memory for allocation
+ */
+static bool ensureCapacity(PtDictionary dictionary) {
+	if (dictionary->size < dictionary->capacity) return true;
+
+	int newCapacity = dictionary->capacity * 2;
+	int *newOffsets = (int *)realloc(dictionary->offsets, newCapacity * sizeof(int));
+	if (newOffsets == NULL) return false;
+	dictionary->offsets = newOffsets;
+
+	unsigned int *newHashes = (unsigned int *)realloc(dictionary->hashes, newCapacity * sizeof(unsigned int));
+	if (newHashes == NULL) return false;
+	dictionary->hashes = newHashes;
+
+	int newSlotCount = dictionary->slotCount * 2;
+	int *newSlots = (int *)malloc(newSlotCount * sizeof(int));
+	if (newSlots == NULL) return false;
+
+	/* rehash every code, using the cached hashes */
+	memset(newSlots, -1, newSlotCount * sizeof(int));
+	for (int code = 0; code < dictionary->size; code++) {
+		int slot = dictionary->hashes[code] & (newSlotCount - 1);
+		while (newSlots[slot] != -1) slot = (slot + 1) & (newSlotCount - 1);
+		newSlots[slot] = code;
+	}
+
+	free(dictionary->slots);
+	dictionary->slots = newSlots;
+	dictionary->slotCount = newSlotCount;
+	dictionary->capacity = newCapacity;
+	return true;
+}
+
+PtDictionary dictionaryCreate(unsigned int initialCapacity) {
+	PtDictionary dictionary = (PtDictionary)calloc(1, sizeof(DictionaryImpl));
+	if (dictionary == NULL) return NULL;
+
+	int capacity = initialCapacity > 0 ? initialCapacity : 1;
+	int slotCount = 2;
+	while (slotCount < 2 * capacity) slotCount *= 2;
+
+	dictionary->capacity = capacity;
+	dictionary->slotCount = slotCount;
+	dictionary->charactersCapacity = 16 * capacity;
+	dictionary->offsets = (int *)malloc(capacity * sizeof(int));
+	dictionary->hashes = (unsigned int *)malloc(capacity * sizeof(unsigned int));
+	dictionary->slots = (int *)malloc(slotCount * sizeof(int));
+	dictionary->characters = (char *)malloc(dictionary->charactersCapacity);
+
+	if (dictionary->offsets == NULL || dictionary->hashes == NULL || dictionary->slots == NULL || dictionary->characters == NULL) {
+		dictionaryDestroy(&dictionary);
+		return NULL;
+	}
+
+	memset(dictionary->slots, -1, slotCount * sizeof(int));
+	return dictionary;
+}
+
+void dictionaryDestroy(PtDictionary *ptDictionary) {
+	PtDictionary dictionary = *ptDictionary;
+	if (dictionary == NULL) return;
+
+	free(dictionary->characters);
+	free(dictionary->offsets);
+	free(dictionary->hashes);
+	free(dictionary->slots);
+	free(dictionary);
+
+	*ptDictionary = NULL;
+}
+
+int dictionaryIntern(PtDictionary dictionary, const char *text, int length) {
+	unsigned int hash = hashString(text, length);
+	int slot = findSlot(dictionary, text, length, hash);
+	if (dictionary->slots[slot] != -1) return dictionary->slots[slot];
+
+	if (!ensureCapacity(dictionary)) return DICTIONARY_NO_MEMORY;
+
+	if (dictionary->charactersSize + length + 1 > dictionary->charactersCapacity) {
+		int newCapacity = dictionary->charactersCapacity * 2;
+		while (dictionary->charactersSize + length + 1 > newCapacity) newCapacity *= 2;
+		char *newCharacters = (char *)realloc(dictionary->characters, newCapacity);
+		if (newCharacters == NULL) return DICTIONARY_NO_MEMORY;
+		dictionary->characters = newCharacters;
+		dictionary->charactersCapacity = newCapacity;
+	}
+
+	int code = dictionary->size++;
+	dictionary->offsets[code] = dictionary->charactersSize;
+	dictionary->hashes[code] = hash;
+	memcpy(dictionary->characters + dictionary->charactersSize, text, length);
+	dictionary->characters[dictionary->charactersSize + length] = '\0';
+	dictionary->charactersSize += length + 1;
+
+	/* the table may have been rehashed by ensureCapacity */
+	dictionary->slots[findSlot(dictionary, text, length, hash)] = code;
+	return code;
+}
+
+int dictionaryFind(PtDictionary dictionary, const char *text) {
+	if (dictionary == NULL) return DICTIONARY_UNKNOWN;
+
+	int length = strlen(text);
+	int slot = findSlot(dictionary, text, length, hashString(text, length));
+	return dictionary->slots[slot] != -1 ? dictionary->slots[slot] : DICTIONARY_UNKNOWN;
+}
+
+const char *dictionaryString(PtDictionary dictionary, int code) {
+	if (dictionary == NULL || code < 0 || code >= dictionary->size) return "";
+
+	return dictionary->characters + dictionary->offsets[code];
+}
+
+int dictionarySize(PtDictionary dictionary) {
+	if (dictionary == NULL) return 0;
+
+	return dictionary->size;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file dictionary.h
+ * @brief Definition of the ADT Dictionary in C.
+ * 
+ * A dictionary interns strings: each distinct string added to it
+ * is stored once and identified by a small integer code.
+ * Codes are dense, assigned in order of insertion starting at 0.
+ * 
+ * Defines the type PtDictionary and associated operations.
+ * 
+ * @author Pedro Vitória
+ * @bug No known bugs.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/** Code returned when a string is not in the dictionary. Never equal to a valid code. */
+#define DICTIONARY_UNKNOWN      -1
+/** Code returned when a string can't be added for lack of memory. */
+#define DICTIONARY_NO_MEMORY    -2
+
+/** Forward declaration of the data structure. */
+struct dictionaryImpl;
+
+/** Definition of pointer to the data stucture. */
+typedef struct dictionaryImpl *PtDictionary;
+
+/**
+ * @brief Creates a new empty dictionary.
+ * 
+ * @param initialCapacity [in] The expected number of distinct strings
+ * 
+ * @return PtDictionary pointer to allocated data structure, or
+ * @return NULL if unsufficient memory for allocation
+ */
+PtDictionary dictionaryCreate(unsigned int initialCapacity);
+
+/**
+ * @brief Free all resources of a dictionary.
+ * 
+ * @param ptDictionary [in] ADDRESS OF pointer to the dictionary. Nothing happens if '*ptDictionary' is NULL
+ */
+void dictionaryDestroy(PtDictionary *ptDictionary);
+
+/**
+ * @brief Retrieves the code of a string, adding the string to the dictionary if it isn't there yet.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * @param text [in] the characters of the string, which don't need to be null-terminated
+ * @param length [in] the number of characters of the string
+ * 
+ * @return the code of the string, or
+ * @return DICTIONARY_NO_MEMORY if unsufficient memory for allocation
+ */
+int dictionaryIntern(PtDictionary dictionary, const char *text, int length);
+
+/**
+ * @brief Retrieves the code of a string, without adding it to the dictionary.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * @param text [in] a null-terminated string
+ * 
+ * @return the code of the string, or
+ * @return DICTIONARY_UNKNOWN if the string is not in the dictionary or 'dictionary' is NULL
+ */
+int dictionaryFind(PtDictionary dictionary, const char *text);
+
+/**
+ * @brief Retrieves the string identified by a code.
+ * 
+ * The returned string belongs to the dictionary and remains valid
+ * until the next string is added to it or it is destroyed.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * @param code [in] a code returned by dictionaryIntern
+ * 
+ * @return the null-terminated string, or
+ * @return an empty string if 'code' is not a valid code
+ */
+const char *dictionaryString(PtDictionary dictionary, int code);
+
+/**
+ * @brief Retrieves the number of distinct strings in a dictionary.
+ * 
+ * @param dictionary [in] pointer to the dictionary
+ * 
+ * @return the number of strings, which is also the smallest code not in use, or
+ * @return 0 if 'dictionary' is NULL
+ */
+int dictionarySize(PtDictionary dictionary);
@@ -0,0 +1,101 @@
+/**
+ * @file fieldParsers.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for the parsers of the fields found in the patients' and regions' files.
+ */
+
+#include "fieldParsers.h"
+
+/**
+ * @brief Checks if a character is a decimal digit, without consulting the locale.
+ * 
+ * @param c [in] The character
+ * @return true if the character is between '0' and '9' or,
+ * @return false otherwise
+ */
+static bool isDigit(char c)
+{
+    return (unsigned char)(c - '0') <= 9;
+}
+
+Date parseDate(const char *text, int length)
+{
+    unsigned int components[3] = {0, 0, 0};
+    const int maxDigits[3] = {2, 2, 4};
+
+    int i = 0;
+    for (int component = 0; component < 3 && i < length; component++)
+    {
+        int digits = 0;
+        while (i < length && digits < maxDigits[component] && isDigit(text[i]))
+        {
+            components[component] = components[component] * 10 + (text[i] - '0');
+            digits++;
+            i++;
+        }
+
+        if (digits == 0 || (component < 2 && (i >= length || text[i] != '/')))
+            break;
+        i++;
+    }
+
+    return dateCreate(components[0], components[1], components[2]);
+}
+
+long int parseInteger(const char *text, int length, long int valueIfEmpty)
+{
+    if (length <= 0)
+        return valueIfEmpty;
+
+    int i = 0;
+    bool negative = false;
+    if (text[0] == '-' || text[0] == '+')
+    {
+        negative = text[0] == '-';
+        i++;
+    }
+
+    long int value = 0;
+    for (; i < length && isDigit(text[i]); i++)
+    {
+        value = value * 10 + (text[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+long int parseGroupedInteger(const char *text, int length)
+{
+    long int value = 0;
+    for (int i = 0; i < length; i++)
+    {
+        if (isDigit(text[i]))
+            value = value * 10 + (text[i] - '0');
+        else if (text[i] != ',')
+            break;
+    }
+    return value;
+}
+
+double parseGroupedDecimal(const char *text, int length)
+{
+    double value = 0;
+    int i = 0;
+    for (; i < length; i++)
+    {
+        if (isDigit(text[i]))
+            value = value * 10 + (text[i] - '0');
+        else if (text[i] != ',')
+            break;
+    }
+
+    if (i < length && text[i] == '.')
+    {
+        double scale = 0.1;
+        for (i++; i < length && isDigit(text[i]); i++)
+        {
+            value += (text[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return value;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file fieldParsers.h
+ * @author Pedro Vitória
+ * @brief Defines parsers for the fixed-format fields found in the patients' and regions' files.
+ * <br>Each parser reads the characters of a field in a single pass. Fields don't need to be null-terminated, no memory is allocated and no locale is consulted.
+ */
+
+#pragma once
+
+#include "date.h"
+
+/**
+ * @brief Parses a date in the DD/MM/YYYY format. Days and months may also be written with a single digit.
+ * 
+ * @param text [in] The first character of the field
+ * @param length [in] The number of characters in the field
+ * @return The parsed date, or
+ * @return an unknown date (00/00/0000) if the field is empty. Components missing from a malformed field are 0
+ */
+Date parseDate(const char *text, int length);
+
+/**
+ * @brief Parses a decimal integer, such as an ID or a birth year, with an optional leading sign.
+ * <br>Parsing stops at the first character that is not a digit.
+ * 
+ * @param text [in] The first character of the field
+ * @param length [in] The number of characters in the field
+ * @param valueIfEmpty [in] The value to return if the field is empty
+ * @return The parsed integer
+ */
+long int parseInteger(const char *text, int length, long int valueIfEmpty);
+
+/**
+ * @brief Parses a non-negative integer whose digits may be grouped in thousands by commas (e.g. 53,121,668).
+ * <br>Parsing stops at the first character that is neither a digit nor a comma.
+ * 
+ * @param text [in] The first character of the field
+ * @param length [in] The number of characters in the field
+ * @return The parsed integer, or 0 if the field is empty
+ */
+long int parseGroupedInteger(const char *text, int length);
+
+/**
+ * @brief Parses a non-negative decimal number whose integer part may be grouped in thousands by commas (e.g. 100,222.5).
+ * <br>A period separates the integer part from the fractional part. Parsing stops at the first character that can't belong to the number.
+ * 
+ * @param text [in] The first character of the field
+ * @param length [in] The number of characters in the field
+ * @return The parsed number, or 0 if the field is empty
+ */
+double parseGroupedDecimal(const char *text, int length);
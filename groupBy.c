@@ -0,0 +1,381 @@
+/**
+ * @file groupBy.c
+ * @author Pedro Vitória
+ * @brief Provides the implementation of the hash aggregation operator behind the <b>GROUPBY</b> command
+ */
+
+#include "groupBy.h"
+#include "workerPool.h"
+#include "patientStatsKernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *dimensionNames[GROUP_DIMENSIONS] = {"sex", "status", "region", "country", "infection_case", "age_band", "confirmed_month"};
+static const char *ageBandTexts[AGE_BANDS] = {"[0-15]", "[16-30]", "[31-45]", "[46-60]", "[61-75]", "[76-152]"};
+
+/**
+ * @brief Represents a hash table of groups. Zero-initialize before use.
+ * <br>The groups are kept in a dense array, in order of insertion, and indexed by a table of slots with linear probing.
+ *
+ */
+typedef struct groupTable
+{
+    Group *groups;
+    int size;
+    int capacity;
+    int *slots;    //Index of a group in 'groups', or -1 for an empty slot
+    int slotCount; //Power of two, at least twice the number of groups
+    bool outOfMemory;
+} GroupTable;
+
+/**
+ * @brief The context of a grouping, for parallelReduce.
+ *
+ */
+typedef struct groupScan
+{
+    PtPatientStore store;
+    const Selection *selection; //The patients to group, or NULL for all
+    const int *dimensions;
+    int dimensionCount;
+    const int *codes[GROUP_BY_MAX_DIMENSIONS]; //The dictionary-encoded column of each dimension, or NULL if it isn't one
+    int *monthOfDay;                           //The month of each day of the daily series of the store, if grouping by GROUP_CONFIRMED_MONTH
+} GroupScan;
+
+int groupDimensionFromName(const char *name)
+{
+    for (int dimension = 0; dimension < GROUP_DIMENSIONS; dimension++)
+    {
+        if (strcasecmp(name, dimensionNames[dimension]) == 0)
+            return dimension;
+    }
+    return -1;
+}
+
+const char *groupDimensionName(int dimension)
+{
+    return dimensionNames[dimension];
+}
+
+/**
+ * @brief Retrieves the dictionary that encodes a dimension.
+ *
+ * @param store [in] A columnar store of patients
+ * @param dimension [in] The dimension
+ * @return The dictionary, or
+ * @return NULL if the dimension isn't a string field
+ */
+static PtDictionary dimensionDictionary(PtPatientStore store, int dimension)
+{
+    switch (dimension)
+    {
+    case GROUP_SEX:
+        return store->dictionaries.sexes;
+    case GROUP_STATUS:
+        return store->dictionaries.statuses;
+    case GROUP_REGION:
+        return store->dictionaries.regions;
+    case GROUP_COUNTRY:
+        return store->dictionaries.countries;
+    case GROUP_INFECTION_CASE:
+        return store->dictionaries.infectionReasons;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Retrieves the dictionary-encoded column of a dimension.
+ *
+ * @param store [in] A columnar store of patients
+ * @param dimension [in] The dimension
+ * @return The column, or
+ * @return NULL if the dimension isn't a string field
+ */
+static const int *dimensionCodes(PtPatientStore store, int dimension)
+{
+    switch (dimension)
+    {
+    case GROUP_SEX:
+        return store->sexCodes;
+    case GROUP_STATUS:
+        return store->statusCodes;
+    case GROUP_REGION:
+        return store->regionCodes;
+    case GROUP_COUNTRY:
+        return store->countryCodes;
+    case GROUP_INFECTION_CASE:
+        return store->infectionReasonCodes;
+    default:
+        return NULL;
+    }
+}
+
+const char *groupValueText(PtPatientStore store, int dimension, int value, char buffer[], size_t bufferSize)
+{
+    if (value == GROUP_UNKNOWN)
+        return "unknown";
+
+    if (dimension == GROUP_AGE_BAND)
+        return ageBandTexts[value];
+    if (dimension == GROUP_CONFIRMED_MONTH)
+    {
+        snprintf(buffer, bufferSize, "%02d/%d", value % 12 + 1, value / 12);
+        return buffer;
+    }
+
+    const char *text = dictionaryString(dimensionDictionary(store, dimension), value);
+    return text[0] != '\0' ? text : "unknown";
+}
+
+/**
+ * @brief Finds the value of a dimension for a patient.
+ *
+ * @param scan [in] The grouping
+ * @param d [in] The position of the dimension in the grouping
+ * @param row [in] The row of the patient
+ * @return The value, or GROUP_UNKNOWN
+ */
+static int rowValue(const GroupScan *scan, int d, int row)
+{
+    if (scan->codes[d] != NULL)
+        return scan->codes[d][row];
+
+    PtPatientStore store = scan->store;
+    if (scan->dimensions[d] == GROUP_AGE_BAND)
+        return store->birthYears[row] != -1 ? patientAgeBand(2020 - store->birthYears[row]) : GROUP_UNKNOWN;
+
+    //Every known date lies within the daily series.
+    int day = store->confirmedDays[row];
+    return day > 0 ? scan->monthOfDay[day - store->days.firstDay] : GROUP_UNKNOWN;
+}
+
+/**
+ * @brief Hashes the values of a group.
+ *
+ * @param values [in] The values of the group
+ * @return The hash of the values
+ */
+static unsigned int hashValues(const int values[])
+{
+    unsigned int hash = 0;
+    for (int d = 0; d < GROUP_BY_MAX_DIMENSIONS; d++)
+        hash = (hash ^ (unsigned int)values[d]) * 0x9E3779B1u;
+    return hash ^ (hash >> 16);
+}
+
+/**
+ * @brief Rebuilds the slots of a table with twice as many slots as before, or 16 for an empty table.
+ *
+ * @param table [in] The table
+ * @return true if the slots were rebuilt or,
+ * @return false if insufficient memory for allocation
+ */
+static bool growSlots(GroupTable *table)
+{
+    int slotCount = table->slotCount > 0 ? table->slotCount * 2 : 16;
+    int *slots = (int *)malloc(slotCount * sizeof(int));
+    if (slots == NULL)
+        return false;
+
+    for (int i = 0; i < slotCount; i++)
+        slots[i] = -1;
+    for (int g = 0; g < table->size; g++)
+    {
+        int slot = hashValues(table->groups[g].values) & (slotCount - 1);
+        while (slots[slot] != -1)
+            slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = g;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slotCount = slotCount;
+    return true;
+}
+
+/**
+ * @brief Adds a number of patients to the group of a combination of values, creating the group if needed.
+ *
+ * @param table [in] The table
+ * @param values [in] The values of the group
+ * @param count [in] The number of patients to add
+ */
+static void addToGroup(GroupTable *table, const int values[], int count)
+{
+    if (table->outOfMemory)
+        return;
+    if (2 * (table->size + 1) > table->slotCount && !growSlots(table))
+    {
+        table->outOfMemory = true;
+        return;
+    }
+
+    int mask = table->slotCount - 1;
+    int slot = hashValues(values) & mask;
+    for (; table->slots[slot] != -1; slot = (slot + 1) & mask)
+    {
+        Group *group = &table->groups[table->slots[slot]];
+        if (memcmp(group->values, values, sizeof(group->values)) == 0)
+        {
+            group->count += count;
+            return;
+        }
+    }
+
+    if (table->size == table->capacity)
+    {
+        int newCapacity = table->capacity > 0 ? table->capacity * 2 : 16;
+        Group *newGroups = (Group *)realloc(table->groups, newCapacity * sizeof(Group));
+        if (newGroups == NULL)
+        {
+            table->outOfMemory = true;
+            return;
+        }
+        table->groups = newGroups;
+        table->capacity = newCapacity;
+    }
+
+    Group *group = &table->groups[table->size];
+    memcpy(group->values, values, sizeof(group->values));
+    group->count = count;
+    table->slots[slot] = table->size++;
+}
+
+/**
+ * @brief Groups the patients of a range of rows, for parallelReduce.
+ *
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param partial [in] The table (GroupTable *) of the range
+ * @param context [in] The grouping (GroupScan *)
+ */
+static void groupRows(int begin, int end, void *partial, void *context)
+{
+    const GroupScan *scan = (const GroupScan *)context;
+    GroupTable *table = (GroupTable *)partial;
+    int values[GROUP_BY_MAX_DIMENSIONS] = {0};
+
+    for (int i = begin; i < end; i++)
+    {
+        if (!selectionContains(scan->selection, i))
+            continue;
+        for (int d = 0; d < scan->dimensionCount; d++)
+            values[d] = rowValue(scan, d, i);
+        addToGroup(table, values, 1);
+    }
+}
+
+/**
+ * @brief Merges the groups of a range of rows into the groups of every row, and frees them, for parallelReduce.
+ *
+ * @param result [in] The table (GroupTable *) of every row
+ * @param partial [in] The table (const GroupTable *) of the range
+ * @param context [in] The grouping (GroupScan *)
+ */
+static void mergeGroups(void *result, const void *partial, void *context)
+{
+    GroupTable *table = (GroupTable *)result;
+    const GroupTable *rangeTable = (const GroupTable *)partial;
+
+    for (int g = 0; g < rangeTable->size; g++)
+        addToGroup(table, rangeTable->groups[g].values, rangeTable->groups[g].count);
+    if (rangeTable->outOfMemory)
+        table->outOfMemory = true;
+
+    free(rangeTable->groups);
+    free(rangeTable->slots);
+}
+
+/** The grouping whose groups are being sorted, since qsort passes no context to the comparison. */
+static const GroupScan *sortedScan = NULL;
+
+/**
+ * @brief Compares two values of a dimension by the order of the <b>GROUPBY</b> command: by text, or chronologically, with unknown values last.
+ *
+ * @param dimension [in] The dimension
+ * @param value1 [in] A value
+ * @param value2 [in] Another value
+ * @return A negative value if value1 comes first, a positive value if value2 comes first, or 0 if they are equal
+ */
+static int compareValues(int dimension, int value1, int value2)
+{
+    if (value1 == value2)
+        return 0;
+
+    PtDictionary dictionary = dimensionDictionary(sortedScan->store, dimension);
+    const char *text1 = value1 == GROUP_UNKNOWN || dictionary == NULL ? "" : dictionaryString(dictionary, value1);
+    const char *text2 = value2 == GROUP_UNKNOWN || dictionary == NULL ? "" : dictionaryString(dictionary, value2);
+    bool unknown1 = value1 == GROUP_UNKNOWN || (dictionary != NULL && text1[0] == '\0');
+    bool unknown2 = value2 == GROUP_UNKNOWN || (dictionary != NULL && text2[0] == '\0');
+
+    if (unknown1 || unknown2)
+        return unknown1 - unknown2;
+    if (dictionary != NULL)
+        return strcmp(text1, text2);
+    return value1 < value2 ? -1 : 1;
+}
+
+/**
+ * @brief Compares two groups by their values, dimension by dimension, for qsort.
+ *
+ * @param group1 [in] Pointer to a group
+ * @param group2 [in] Pointer to another group
+ * @return The result of compareValues on the first dimension where the groups differ
+ */
+static int compareGroups(const void *group1, const void *group2)
+{
+    const Group *g1 = (const Group *)group1;
+    const Group *g2 = (const Group *)group2;
+
+    for (int d = 0; d < sortedScan->dimensionCount; d++)
+    {
+        int result = compareValues(sortedScan->dimensions[d], g1->values[d], g2->values[d]);
+        if (result != 0)
+            return result;
+    }
+    return 0;
+}
+
+Group *groupByCount(PtPatientStore store, const Selection *selection, const int dimensions[], int dimensionCount, int *groupCount)
+{
+    GroupScan scan = {store, selection, dimensions, dimensionCount, {NULL}, NULL};
+    for (int d = 0; d < dimensionCount; d++)
+    {
+        scan.codes[d] = dimensionCodes(store, dimensions[d]);
+        if (dimensions[d] == GROUP_CONFIRMED_MONTH && scan.monthOfDay == NULL)
+        {
+            //The month of each day is found once, rather than once per patient.
+            scan.monthOfDay = (int *)malloc((store->days.dayCount > 0 ? store->days.dayCount : 1) * sizeof(int));
+            if (scan.monthOfDay == NULL)
+                return NULL;
+            for (int day = 0; day < store->days.dayCount; day++)
+            {
+                Date date = dateFromEpochDay(store->days.firstDay + day);
+                scan.monthOfDay[day] = date.year * 12 + date.month - 1;
+            }
+        }
+    }
+
+    GroupTable table;
+    memset(&table, 0, sizeof(table));
+    parallelReduce(workerPoolShared(), store->size, sizeof(GroupTable), groupRows, mergeGroups, &table, &scan);
+    free(scan.monthOfDay);
+    free(table.slots);
+
+    if (table.outOfMemory)
+    {
+        free(table.groups);
+        return NULL;
+    }
+
+    sortedScan = &scan;
+    qsort(table.groups, table.size, sizeof(Group), compareGroups);
+    sortedScan = NULL;
+
+    //An empty store has no groups, but the caller still gets an array to free.
+    *groupCount = table.size;
+    return table.groups != NULL ? table.groups : (Group *)malloc(sizeof(Group));
+}
@@ -0,0 +1,84 @@
+/**
+ * @file groupBy.h
+ * @author Pedro Vitória
+ * @brief Defines the hash aggregation operator behind the <b>GROUPBY</b> command, which counts the patients of a store by up to three dimensions.
+ * <br>Each dimension maps a patient to an integer value: the dictionary code of a string field, the index of an age band, or the month of a date.
+ * The patients are grouped by their combination of values in a hash table, in a single scan split among the threads of the shared worker pool.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "patientStore.h"
+
+#define GROUP_SEX 0
+#define GROUP_STATUS 1
+#define GROUP_REGION 2
+#define GROUP_COUNTRY 3
+#define GROUP_INFECTION_CASE 4
+#define GROUP_AGE_BAND 5
+#define GROUP_CONFIRMED_MONTH 6
+
+/** The number of dimensions a store can be grouped by. */
+#define GROUP_DIMENSIONS 7
+
+/** The maximum number of dimensions of a single grouping. */
+#define GROUP_BY_MAX_DIMENSIONS 3
+
+/** The value of a dimension that is unknown for a patient (e.g., the age band of a patient whose birth year is unknown). */
+#define GROUP_UNKNOWN -1
+
+/**
+ * @brief Represents a group of patients: their values for each dimension, and how many they are.
+ *
+ */
+typedef struct group
+{
+    int values[GROUP_BY_MAX_DIMENSIONS];
+    int count;
+} Group;
+
+/**
+ * @brief Finds a dimension by its name, ignoring capitalization.
+ * <br>The names are: sex, status, region, country, infection_case, age_band and confirmed_month.
+ *
+ * @param name [in] The name of the dimension
+ * @return The dimension (GROUP_SEX, ..., GROUP_CONFIRMED_MONTH), or
+ * @return -1 if no dimension has that name
+ */
+int groupDimensionFromName(const char *name);
+
+/**
+ * @brief Retrieves the name of a dimension.
+ *
+ * @param dimension [in] The dimension
+ * @return The name of the dimension
+ */
+const char *groupDimensionName(int dimension);
+
+/**
+ * @brief Retrieves the text of a value of a dimension, as shown by the <b>GROUPBY</b> command.
+ *
+ * @param store [in] A columnar store of patients
+ * @param dimension [in] The dimension
+ * @param value [in] The value
+ * @param buffer [in] A buffer for the values that aren't strings of the store
+ * @param bufferSize [in] The size of the buffer, in bytes
+ * @return The text of the value, "unknown" for GROUP_UNKNOWN and empty strings
+ */
+const char *groupValueText(PtPatientStore store, int dimension, int value, char buffer[], size_t bufferSize);
+
+/**
+ * @brief Counts the patients of a store by the combination of their values for a set of dimensions.
+ * <br>The groups are sorted by the text of their values, dimension by dimension, with unknown values last.
+ * Ages bands and months are sorted in chronological order.
+ *
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to count, or NULL for all
+ * @param dimensions [in] The dimensions to group by
+ * @param dimensionCount [in] The number of dimensions, from 1 to GROUP_BY_MAX_DIMENSIONS
+ * @param groupCount [out] The number of groups
+ * @return An array with the groups, to be freed by the caller, or
+ * @return NULL if insufficient memory for allocation
+ */
+Group *groupByCount(PtPatientStore store, const Selection *selection, const int dimensions[], int dimensionCount, int *groupCount);
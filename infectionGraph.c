@@ -0,0 +1,240 @@
+/**
+ * @file infectionGraph.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>InfectionGraph</i></b> data type
+ */
+
+#include "infectionGraph.h"
+#include <stdlib.h>
+#include <limits.h>
+
+/**
+ * @brief Starts a new traversal of a graph, so that no row is marked as visited.
+ * <br>Marks are reset only when the epoch wraps around, so starting a traversal usually takes constant time.
+ * 
+ * @param graph [in] The graph
+ * @return The mark of the rows visited by the new traversal
+ */
+static int newTraversal(InfectionGraph *graph)
+{
+    if (graph->markEpoch == INT_MAX)
+    {
+        for (int i = 0; i < graph->size; i++)
+            graph->marks[i] = 0;
+        graph->markEpoch = 0;
+    }
+    return ++graph->markEpoch;
+}
+
+bool infectionGraphBuild(InfectionGraph *graph, PtList patientsList, DatasetArena *arena)
+{
+    const ListElem *patients;
+    int size = 0;
+    listSpan(patientsList, &patients, &size);
+
+    size_t rows = size > 0 ? size : 1;
+    datasetArenaReserve(arena, (4 * rows + 1) * sizeof(int) + 4 * (DATASET_ARENA_ALIGNMENT - 1));
+    graph->size = size;
+    graph->parents = datasetArenaAlloc(arena, rows * sizeof(int));
+    graph->childOffsets = datasetArenaAlloc(arena, (rows + 1) * sizeof(int));
+    graph->children = datasetArenaAlloc(arena, rows * sizeof(int));
+    graph->marks = datasetArenaAlloc(arena, rows * sizeof(int));
+    graph->markEpoch = 0;
+    if (graph->parents == NULL || graph->childOffsets == NULL || graph->children == NULL || graph->marks == NULL)
+        return false;
+
+    //Resolve each infector through the ID index of the list, counting the children of each row.
+    for (int i = 0; i <= size; i++)
+        graph->childOffsets[i] = 0;
+    for (int i = 0; i < size; i++)
+    {
+        int parent = -1;
+        if (patients[i].infectedBy != -1 && listFind(patientsList, patients[i].infectedBy, &parent) != LIST_OK)
+            parent = -1;
+
+        graph->parents[i] = parent;
+        graph->marks[i] = 0;
+        if (parent != -1)
+            graph->childOffsets[parent + 1]++;
+    }
+
+    //Turn the counts into offsets, then place each child, in row order, at the next free position of its parent.
+    for (int i = 0; i < size; i++)
+        graph->childOffsets[i + 1] += graph->childOffsets[i];
+
+    int *nextChild = graph->marks; //The marks are free until the first traversal.
+    for (int i = 0; i < size; i++)
+        nextChild[i] = graph->childOffsets[i];
+    for (int i = 0; i < size; i++)
+    {
+        if (graph->parents[i] != -1)
+            graph->children[nextChild[graph->parents[i]]++] = i;
+    }
+    for (int i = 0; i < size; i++)
+        graph->marks[i] = 0;
+
+    return true;
+}
+
+bool infectionGraphAttach(InfectionGraph *graph, DatasetArena *arena)
+{
+    graph->marks = datasetArenaAlloc(arena, (graph->size > 0 ? graph->size : 1) * sizeof(int));
+    graph->markEpoch = 0;
+    if (graph->marks == NULL)
+        return false;
+
+    for (int i = 0; i < graph->size; i++)
+        graph->marks[i] = 0;
+    return true;
+}
+
+int infectionGraphChain(InfectionGraph *graph, int row, int chain[], bool *cycle)
+{
+    int mark = newTraversal(graph);
+    int length = 0;
+
+    *cycle = false;
+    while (row != -1)
+    {
+        if (graph->marks[row] == mark)
+        {
+            *cycle = true;
+            break;
+        }
+        graph->marks[row] = mark;
+        chain[length++] = row;
+        row = graph->parents[row];
+    }
+    return length;
+}
+
+int infectionGraphDescendants(InfectionGraph *graph, int row, int descendants[])
+{
+    int mark = newTraversal(graph);
+    int count = 0;
+
+    //The output array doubles as the queue of the breadth-first search.
+    graph->marks[row] = mark;
+    int current = row;
+    for (int next = 0; current != -1; current = next < count ? descendants[next++] : -1)
+    {
+        for (int c = graph->childOffsets[current]; c < graph->childOffsets[current + 1]; c++)
+        {
+            int child = graph->children[c];
+            if (graph->marks[child] != mark)
+            {
+                graph->marks[child] = mark;
+                descendants[count++] = child;
+            }
+        }
+    }
+    return count;
+}
+
+int infectionGraphDepth(InfectionGraph *graph, int row)
+{
+    int mark = newTraversal(graph);
+    int depth = 0;
+
+    graph->marks[row] = mark;
+    for (int parent = graph->parents[row]; parent != -1 && graph->marks[parent] != mark; parent = graph->parents[parent])
+    {
+        graph->marks[parent] = mark;
+        depth++;
+    }
+    return depth;
+}
+
+/**
+ * @brief Adds up the descendants of a range of rows laid out in breadth-first order, from the last row up.
+ * <br>Every child of a row in the range must come after it in the range, so that their counts are final when the row is reached.
+ * 
+ * @param graph [in] The graph
+ * @param order [in] The rows, in breadth-first order
+ * @param first [in] The position of the first row of the range
+ * @param end [in] The position right after the last row of the range
+ * @param totals [out] The number of descendants of each row of the range
+ */
+static void accumulateDescendants(InfectionGraph *graph, const int order[], int first, int end, int totals[])
+{
+    for (int i = end - 1; i >= first; i--)
+    {
+        int row = order[i];
+        int total = 0;
+        for (int c = graph->childOffsets[row]; c < graph->childOffsets[row + 1]; c++)
+            total += 1 + totals[graph->children[c]];
+        totals[row] = total;
+    }
+}
+
+bool infectionGraphCountDescendants(InfectionGraph *graph, int totals[])
+{
+    int *order = (int *)malloc((graph->size > 0 ? graph->size : 1) * sizeof(int));
+    if (order == NULL)
+        return false;
+
+    //A row is laid out once, when its parent is: -1 marks the rows not laid out yet.
+    int count = 0;
+    for (int i = 0; i < graph->size; i++)
+    {
+        totals[i] = -1;
+        if (graph->parents[i] == -1)
+        {
+            totals[i] = 0;
+            order[count++] = i;
+        }
+    }
+    for (int next = 0; next < count; next++)
+    {
+        for (int c = graph->childOffsets[order[next]]; c < graph->childOffsets[order[next] + 1]; c++)
+        {
+            totals[graph->children[c]] = 0;
+            order[count++] = graph->children[c];
+        }
+    }
+    accumulateDescendants(graph, order, 0, count, totals);
+
+    //The rows left out belong to loops, each with branches of its own. Every patient of the loop reaches the whole component.
+    int mark = newTraversal(graph);
+    for (int i = 0; i < graph->size; i++)
+    {
+        if (totals[i] != -1)
+            continue;
+
+        int row = i;
+        while (graph->marks[row] != mark)
+        {
+            graph->marks[row] = mark;
+            row = graph->parents[row];
+        }
+
+        //row is now in the loop. -2 marks its patients, so that the breadth-first search doesn't go around the loop.
+        int first = count;
+        do
+        {
+            totals[row] = -2;
+            order[count++] = row;
+            row = graph->parents[row];
+        } while (row != order[first]);
+
+        int branches = count;
+        for (int next = first; next < count; next++)
+        {
+            for (int c = graph->childOffsets[order[next]]; c < graph->childOffsets[order[next] + 1]; c++)
+            {
+                if (totals[graph->children[c]] == -1)
+                {
+                    totals[graph->children[c]] = 0;
+                    order[count++] = graph->children[c];
+                }
+            }
+        }
+        accumulateDescendants(graph, order, branches, count, totals);
+
+        for (int j = first; j < branches; j++)
+            totals[order[j]] = count - first - 1;
+    }
+
+    free(order);
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file infectionGraph.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>InfectionGraph</i></b> and related operations.
+ * <br>An infection graph links each patient to the patient who infected them (their parent) and to the patients they infected (their children).
+ * Patients are identified by their row in the patient store. The children are kept in compressed sparse row (CSR) form:
+ * the children of row <b>r</b> are <b>children[childOffsets[r]]</b> to <b>children[childOffsets[r + 1] - 1]</b>, in increasing order.
+ */
+
+#pragma once
+
+#include "list.h"
+#include "datasetArena.h"
+
+/**
+ * @brief Represents an infection graph.
+ * 
+ */
+typedef struct infectionGraph
+{
+    int size;
+    int *parents;      //Row of the infector of each patient, or -1 if unknown or not in the data
+    int *childOffsets; //size + 1 offsets into children
+    int *children;
+    int *marks;        //Per-row visit marks of the traversals, compared against markEpoch
+    int markEpoch;
+} InfectionGraph;
+
+/**
+ * @brief Builds the infection graph of a list of patients.
+ * <br>A patient infected by an ID shared by several patients is linked to the first of them, like a search by ID would.
+ * 
+ * @param graph [out] The graph
+ * @param patientsList [in] A list of patients
+ * @param arena [in] The arena that will hold the arrays of the graph
+ * @return true if the graph was successfully built or,
+ * @return false if insufficient memory for allocation
+ */
+bool infectionGraphBuild(InfectionGraph *graph, PtList patientsList, DatasetArena *arena);
+
+/**
+ * @brief Prepares a graph whose parents and children already exist, such as those of a mapped snapshot, for traversals.
+ * <br>Only the visit marks are allocated: the parents and children are used as they are, and never written.
+ * 
+ * @param graph [in] The graph, whose size, parents, child offsets and children are set
+ * @param arena [in] The arena that will hold the visit marks
+ * @return true if the graph was successfully prepared or,
+ * @return false if insufficient memory for allocation
+ */
+bool infectionGraphAttach(InfectionGraph *graph, DatasetArena *arena);
+
+/**
+ * @brief Retrieves the chain of infectors of a patient: the patient, their infector, the infector's infector, and so on.
+ * <br>The walk stops at a patient whose infector is unknown or not in the data, or right before a patient would appear a second time.
+ * 
+ * @param graph [in] The graph
+ * @param row [in] The row of the first patient of the chain
+ * @param chain [out] An array of at least <b>size</b> elements, filled with the rows of the chain
+ * @param cycle [out] Whether the walk stopped because the chain loops back to one of its patients
+ * @return The number of patients in the chain
+ */
+int infectionGraphChain(InfectionGraph *graph, int row, int chain[], bool *cycle);
+
+/**
+ * @brief Retrieves every patient infected, directly or not, by a patient, in breadth-first order.
+ * <br>Takes time proportional to the number of patients retrieved.
+ * 
+ * @param graph [in] The graph
+ * @param row [in] The row of the patient
+ * @param descendants [out] An array of at least <b>size</b> elements, filled with the rows of the descendants
+ * @return The number of descendants, not counting the patient
+ */
+int infectionGraphDescendants(InfectionGraph *graph, int row, int descendants[]);
+
+/**
+ * @brief Retrieves the depth of a patient: the number of infections between the first known infector of their chain and them.
+ * <br>Takes time proportional to the depth.
+ * 
+ * @param graph [in] The graph
+ * @param row [in] The row of the patient
+ * @return The depth, 0 for a patient whose infector is unknown
+ */
+int infectionGraphDepth(InfectionGraph *graph, int row);
+
+/**
+ * @brief Counts, for every patient, the patients they infected directly or not, in a single post-order pass over the graph.
+ * <br>The rows are laid out in breadth-first order from the patients whose infector is unknown, and the counts are then accumulated from the last row up,
+ * so that each patient adds up their children's counts. Patients in a chain that loops back on itself all infected every other patient of that loop and of its branches.
+ * Takes time proportional to the number of patients.
+ * 
+ * @param graph [in] The graph
+ * @param totals [out] An array of at least <b>size</b> elements, filled with the number of descendants of each row
+ * @return true if the counts were successfully computed or,
+ * @return false if insufficient memory for allocation
+ */
+bool infectionGraphCountDescendants(InfectionGraph *graph, int totals[]);
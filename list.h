@@ -16,6 +16,7 @@
 #define LIST_EMPTY			3
 #define LIST_FULL			4
 #define LIST_INVALID_RANK	5
+#define LIST_UNKNOWN_KEY	6
 
 #include "listElem.h"
 #include <stdbool.h>
@@ -26,6 +27,15 @@ struct listImpl;
 /** Definition of pointer to the  data stucture. */
 typedef struct listImpl *PtList;
 
+/** 
+ * Iterator over the elements of a list, by increasing rank.
+ * Create with listIterate and advance with listNext.
+ */
+typedef struct listIterator {
+	PtList list;
+	int rank;	/* rank of the next element */
+} ListIterator;
+
 /**
  * @brief Creates a new empty list.
  * 
@@ -36,6 +46,23 @@ typedef struct listImpl *PtList;
  */
 PtList listCreate(unsigned int initialCapacity);
 
+/**
+ * @brief Creates a new list over an existing array of elements,
+ * without copying them.
+ * 
+ * The list shares the array with its owner, e.g., a file mapped
+ * into memory, so the array must outlive the list. The array is
+ * never written: the list copies the elements into an array of
+ * its own the first time it is changed.
+ * 
+ * @param elems [in] array of elements
+ * @param count [in] number of elements of the array
+ * 
+ * @return PtList pointer to allocated data structure, or
+ * @return NULL if unsufficient memory for allocation
+ */
+PtList listCreateShared(const ListElem elems[], int count);
+
 /**
  * @brief Free all resources of a list.
  * 
@@ -63,6 +90,62 @@ int listDestroy(PtList *ptList);
  */
 int listAdd(PtList list, int rank, ListElem elem);
 
+/**
+ * @brief Appends an element to the end of a list.
+ * 
+ * Equivalent to listAdd at rank 'size', without 
+ * having to retrieve the size first.
+ * 
+ * @param list [in] pointer to the list
+ * @param elem  [in] element to append
+ * 
+ * @return LIST_OK if successful, or
+ * @return LIST_FULL if no capacity available, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listAppend(PtList list, ListElem elem);
+
+/**
+ * @brief Appends an array of elements to the end of a list,
+ * in order, growing the list at most once.
+ * 
+ * @param list [in] pointer to the list
+ * @param elems [in] array of elements to append
+ * @param count [in] number of elements in 'elems'
+ * 
+ * @return LIST_OK if successful, or
+ * @return LIST_INVALID_RANK if 'count' is negative, or
+ * @return LIST_NO_MEMORY if unsufficient memory for allocation, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listAppendRange(PtList list, const ListElem elems[], int count);
+
+/**
+ * @brief Ensures a list can hold a number of elements
+ * without growing again.
+ * 
+ * The capacity is never decreased.
+ * 
+ * @param list [in] pointer to the list
+ * @param capacity [in] number of elements to make room for
+ * 
+ * @return LIST_OK if successful, or
+ * @return LIST_NO_MEMORY if unsufficient memory for allocation, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listReserve(PtList list, int capacity);
+
+/**
+ * @brief Releases the capacity of a list beyond its size.
+ * 
+ * @param list [in] pointer to the list
+ * 
+ * @return LIST_OK if successful, or
+ * @return LIST_NO_MEMORY if unsufficient memory for allocation, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listShrinkToFit(PtList list);
+
 /**
  * @brief Removes an element from a list.
  * 
@@ -75,6 +158,8 @@ int listAdd(PtList list, int rank, ListElem elem);
  * @return LIST_OK if successful and value in 'ptElem', or
  * @return LIST_INVALID_RANK if 'rank' is invalid, or
  * @return LIST_EMPTY if the list is empty, or
+ * @return LIST_NO_MEMORY if the elements are shared (see listCreateShared)
+ * and unsufficient memory for an array of its own, or
  * @return LIST_NULL if 'list' is NULL 
  */
 int listRemove(PtList list, int rank, ListElem *ptElem);
@@ -95,6 +180,83 @@ int listRemove(PtList list, int rank, ListElem *ptElem);
  */
 int listGet(PtList list, int rank, ListElem *ptElem);
 
+/**
+ * @brief Borrows an element of a list, without copying it.
+ * 
+ * The specified rank must be in [0, size - 1].
+ * 
+ * The element must not be changed through the pointer, which
+ * remains valid until the list is modified or destroyed.
+ * 
+ * @param list [in] pointer to the list
+ * @param rank [in] rank for retrieval
+ * @param ptElem [out] address of variable to hold the pointer to the element
+ * 
+ * @return LIST_OK if successful and pointer in 'ptElem', or
+ * @return LIST_INVALID_RANK if 'rank' is invalid, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listBorrow(PtList list, int rank, const ListElem **ptElem);
+
+/**
+ * @brief Borrows all elements of a list, as a contiguous array
+ * ordered by rank, without copying them.
+ * 
+ * The elements must not be changed through the pointer, which
+ * remains valid until the list is modified or destroyed.
+ * 
+ * @param list [in] pointer to the list
+ * @param ptElems [out] address of variable to hold the pointer to the first element
+ * @param ptSize [out] address of variable to hold the number of elements
+ * 
+ * @return LIST_OK if successful and pointer in 'ptElems', or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listSpan(PtList list, const ListElem **ptElems, int *ptSize);
+
+/**
+ * @brief Creates an iterator over the elements of a list,
+ * starting at rank 0.
+ * 
+ * The list must not be modified while the iterator is in use.
+ * 
+ * @param list [in] pointer to the list
+ * 
+ * @return the iterator. If 'list' is NULL it yields no elements
+ */
+ListIterator listIterate(PtList list);
+
+/**
+ * @brief Borrows the next element of an iterator and advances it.
+ * 
+ * @param iterator [in] address of the iterator
+ * @param ptElem [out] address of variable to hold the pointer to the element,
+ * valid under the same conditions as listBorrow
+ * 
+ * @return 'true' if there was a next element, or
+ * @return 'false' if the iterator reached the end of the list
+ */
+bool listNext(ListIterator *iterator, const ListElem **ptElem);
+
+/**
+ * @brief Finds the rank of the first element with a given key.
+ * 
+ * Keys are obtained with listElemKey. The list keeps a hash index
+ * of its elements by key, so this operation takes constant
+ * expected time. The index is updated when elements are appended
+ * and rebuilt on the first search after any other modification.
+ * 
+ * @param list [in] pointer to the list
+ * @param key [in] key to find
+ * @param ptRank [out] address of variable to hold the rank
+ * 
+ * @return LIST_OK if successful and rank in 'ptRank', or
+ * @return LIST_UNKNOWN_KEY if no element has the key, or
+ * @return LIST_NO_MEMORY if unsufficient memory to build the index, or
+ * @return LIST_NULL if 'list' is NULL 
+ */
+int listFind(PtList list, ListElemKey key, int *ptRank);
+
 /**
  * @brief Replaces an element from a list.
  * 
@@ -110,6 +272,8 @@ int listGet(PtList list, int rank, ListElem *ptElem);
  * @return LIST_OK if successful and previous value in 'ptOldElem', or
  * @return LIST_INVALID_RANK if 'rank' is invalid, or
  * @return LIST_EMPTY if the list is empty, or
+ * @return LIST_NO_MEMORY if the elements are shared (see listCreateShared)
+ * and unsufficient memory for an array of its own, or
  * @return LIST_NULL if 'list' is NULL 
  */
 int listSet(PtList list, int rank, ListElem elem, ListElem *ptOldElem);
@@ -144,6 +308,8 @@ bool listIsEmpty(PtList list);
  * @param list [in] pointer to the list
  * 
  * @return LIST_OK if successful, or
+ * @return LIST_NO_MEMORY if the elements are shared (see listCreateShared)
+ * and unsufficient memory for an array of its own, or
  * @return LIST_NULL if 'list' is NULL 
  */
 int listClear(PtList list);
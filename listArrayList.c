@@ -11,24 +11,139 @@
 #include "list.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+typedef struct indexSlot {
+	unsigned int tag;	/* high bits of the hash of the key */
+	int rank;			/* rank of the first element with the key, -1 if empty */
+} IndexSlot;
 
 typedef struct listImpl {
 	ListElem* elements;
 	int size; 
 	int capacity;
+	IndexSlot* index;	/* open-addressing hash index of the elements by key */
+	int indexSlots;		/* power of two, at least twice 'size' */
+	bool indexValid;	/* false if the index must be rebuilt before use */
+	bool shared;		/* true if 'elements' belongs to someone else, see listCreateShared */
 } ListImpl;
 
+/**
+ * @brief Auxiliary function to hash a key (Fibonacci hashing).
+ * 
+ * @param key [in] key to hash
+ * @return the high 32 bits of the hash, used both to pick
+ * a slot and as the tag of the slot
+ */
+static unsigned int hashKey(ListElemKey key) {
+	return (unsigned int)(((unsigned long long)key * 0x9E3779B97F4A7C15ull) >> 32);
+}
 
-bool ensureCapacity(PtList list) {
-	if (list->size == list->capacity) {
-		int newCapacity = list->capacity * 2;
-		ListElem* newArray = (ListElem*) realloc( list->elements, 
-								newCapacity * sizeof(ListElem) );
-		
+/**
+ * @brief Auxiliary function to index the element at a given rank.
+ * 
+ * If an element with the same key is already indexed, the index
+ * is left unchanged, so that it always refers to the first
+ * element with a key as long as ranks are indexed in order.
+ * 
+ * @param list [in] pointer to the list
+ * @param rank [in] rank of the element to index
+ */
+static void indexRank(PtList list, int rank) {
+	ListElemKey key = listElemKey(list->elements[rank]);
+	unsigned int tag = hashKey(key);
+	int mask = list->indexSlots - 1;
+	int slot = tag & mask;
+
+	while (list->index[slot].rank != -1) {
+		if (list->index[slot].tag == tag && listElemKey(list->elements[list->index[slot].rank]) == key) return;
+		slot = (slot + 1) & mask;
+	}
+	list->index[slot].tag = tag;
+	list->index[slot].rank = rank;
+}
+
+/**
+ * @brief Auxiliary function to (re)build the index of a list,
+ * with enough slots for its capacity.
+ * 
+ * @param list [in] pointer to the list
+ * @return true if the index was built, or
+ * @return false if unsufficient memory for allocation
+ */
+static bool rebuildIndex(PtList list) {
+	int slots = 16;
+	while (slots < 2 * list->capacity) slots *= 2;
+
+	if (slots != list->indexSlots) {
+		IndexSlot* newIndex = (IndexSlot*) realloc(list->index, slots * sizeof(IndexSlot));
+		if (newIndex == NULL) {
+			list->indexValid = false;
+			return false;
+		}
+		list->index = newIndex;
+		list->indexSlots = slots;
+	}
+
+	for (int i = 0; i < slots; i++) list->index[i].rank = -1;
+	for (int rank = 0; rank < list->size; rank++) indexRank(list, rank);
+
+	list->indexValid = true;
+	return true;
+}
+
+
+/**
+ * @brief Auxiliary function to change the capacity of a list.
+ * 
+ * The index is rebuilt for the new capacity. If that fails,
+ * it is rebuilt on the next search instead.
+ * 
+ * @param list [in] pointer to the list
+ * @param newCapacity [in] new capacity, not less than the size of the list
+ * @return true if the capacity was changed, or
+ * @return false if unsufficient memory for allocation
+ */
+static bool resize(PtList list, int newCapacity) {
+	if (newCapacity < 1) newCapacity = 1;
+
+	ListElem* newArray;
+	if (list->shared) {
+		/* a shared array is copied, never reallocated */
+		newArray = (ListElem*) malloc( (size_t)newCapacity * sizeof(ListElem) );
+		if(newArray == NULL) return false;
+		memcpy(newArray, list->elements, (size_t)list->size * sizeof(ListElem));
+		list->shared = false;
+	}
+	else {
+		newArray = (ListElem*) realloc( list->elements, 
+							(size_t)newCapacity * sizeof(ListElem) );
 		if(newArray == NULL) return false;
+	}
+
+	list->elements = newArray;
+	list->capacity = newCapacity;
+
+	if (list->indexValid) rebuildIndex(list);
+
+	return true;
+}
+
+/**
+ * @brief Auxiliary function to give a list an array of its own,
+ * before its elements are changed.
+ * 
+ * @param list [in] pointer to the list
+ * @return true if the list owns its array, or
+ * @return false if unsufficient memory for allocation
+ */
+static bool ownElements(PtList list) {
+	return !list->shared || resize(list, list->capacity);
+}
 
-		list->elements = newArray;
-		list->capacity = newCapacity;
+bool ensureCapacity(PtList list) {
+	if (list->size == list->capacity) {
+		return resize(list, list->capacity * 2);
 	}
 	
 	return true;
@@ -38,6 +153,7 @@ PtList listCreate(unsigned int initialCapacity) {
 	PtList list = (PtList)malloc(sizeof(ListImpl));
 	if (list == NULL) return NULL;
 
+	if (initialCapacity < 1) initialCapacity = 1;
 	list->elements = (ListElem*)calloc(initialCapacity,
 										sizeof(ListElem));
 
@@ -48,6 +164,27 @@ PtList listCreate(unsigned int initialCapacity) {
 
 	list->size = 0;
 	list->capacity = initialCapacity;
+	list->index = NULL;
+	list->indexSlots = 0;
+	list->shared = false;
+	rebuildIndex(list);
+
+	return list;
+}
+
+PtList listCreateShared(const ListElem elems[], int count) {
+	PtList list = (PtList)malloc(sizeof(ListImpl));
+	if (list == NULL) return NULL;
+
+	/* the index is only built by the first search, so creating the
+	   list takes constant time */
+	list->elements = (ListElem*)elems;
+	list->size = count;
+	list->capacity = count;
+	list->index = NULL;
+	list->indexSlots = 0;
+	list->indexValid = false;
+	list->shared = true;
 
 	return list;
 }
@@ -56,7 +193,8 @@ int listDestroy(PtList *ptList) {
 	PtList list = *ptList;
 	if (list == NULL) return LIST_NULL;
 
-	free(list->elements);
+	if (!list->shared) free(list->elements);
+	free(list->index);
 	free(list);
 
 	*ptList = NULL;
@@ -67,7 +205,7 @@ int listDestroy(PtList *ptList) {
 int listAdd(PtList list, int rank, ListElem elem) {
 	if (list == NULL) return LIST_NULL;
 	if (rank < 0 || rank > list->size) return LIST_INVALID_RANK;
-	if(!ensureCapacity(list)) return LIST_FULL;
+	if(!ownElements(list) || !ensureCapacity(list)) return LIST_FULL;
 
 	/* make room for new element at index 'rank' */
 	for(int i = list->size; i > rank; i--) {
@@ -78,6 +216,63 @@ int listAdd(PtList list, int rank, ListElem elem) {
 
 	list->size++;
 
+	/* appending keeps the ranks of the other elements, so the index
+	   is updated in place, otherwise it is rebuilt when next used */
+	if (list->indexValid && rank == list->size - 1) {
+		indexRank(list, rank);
+	}
+	else {
+		list->indexValid = false;
+	}
+
+	return LIST_OK;
+}
+
+int listAppend(PtList list, ListElem elem) {
+	if (list == NULL) return LIST_NULL;
+	if(!ownElements(list) || !ensureCapacity(list)) return LIST_FULL;
+
+	list->elements[list->size] = elem;
+	if (list->indexValid) indexRank(list, list->size);
+	list->size++;
+
+	return LIST_OK;
+}
+
+int listAppendRange(PtList list, const ListElem elems[], int count) {
+	if (list == NULL) return LIST_NULL;
+	if (count < 0) return LIST_INVALID_RANK;
+	if (!ownElements(list)) return LIST_NO_MEMORY;
+
+	/* grow at least geometrically, so that repeated calls stay amortized */
+	if (list->capacity - list->size < count) {
+		int newCapacity = list->capacity * 2;
+		if (newCapacity < list->size + count) newCapacity = list->size + count;
+		if (!resize(list, newCapacity)) return LIST_NO_MEMORY;
+	}
+
+	memcpy(list->elements + list->size, elems, (size_t)count * sizeof(ListElem));
+	for (int i = 0; i < count && list->indexValid; i++) {
+		indexRank(list, list->size + i);
+	}
+	list->size += count;
+
+	return LIST_OK;
+}
+
+int listReserve(PtList list, int capacity) {
+	if (list == NULL) return LIST_NULL;
+
+	if (capacity > list->capacity && !resize(list, capacity)) return LIST_NO_MEMORY;
+
+	return LIST_OK;
+}
+
+int listShrinkToFit(PtList list) {
+	if (list == NULL) return LIST_NULL;
+
+	if (list->capacity > list->size && list->capacity > 1 && !resize(list, list->size)) return LIST_NO_MEMORY;
+
 	return LIST_OK;
 }
 
@@ -85,6 +280,7 @@ int listRemove(PtList list, int rank, ListElem *ptElem) {
 	if (list == NULL) return LIST_NULL;
 	if (list->size == 0) return LIST_EMPTY;
 	if (rank < 0 || rank > list->size - 1) return LIST_INVALID_RANK;
+	if (!ownElements(list)) return LIST_NO_MEMORY;
 
 	/* return by-reference the element at specified rank*/
 	*ptElem = list->elements[rank];
@@ -95,6 +291,7 @@ int listRemove(PtList list, int rank, ListElem *ptElem) {
 	}
 
 	list->size--;
+	list->indexValid = false;
 
 	return LIST_OK;
 }
@@ -112,15 +309,70 @@ int listGet(PtList list, int rank, ListElem *ptElem) {
 int listSet(PtList list, int rank, ListElem elem, ListElem *ptOldElem) {
 	if (list == NULL) return LIST_NULL;
 	if (rank < 0 || rank > list->size - 1) return LIST_INVALID_RANK;
+	if (!ownElements(list)) return LIST_NO_MEMORY;
 
 	/* 	return by-reference the element at specified rank 
 		and place the new one. The size remains the same */
 	*ptOldElem = list->elements[rank];
 	list->elements[rank] = elem;
 
+	if (listElemKey(elem) != listElemKey(*ptOldElem)) list->indexValid = false;
+
 	return LIST_OK;
 }
 
+int listBorrow(PtList list, int rank, const ListElem **ptElem) {
+	if (list == NULL) return LIST_NULL;
+	if (rank < 0 || rank > list->size - 1) return LIST_INVALID_RANK;
+
+	*ptElem = &list->elements[rank];
+
+	return LIST_OK;
+}
+
+int listSpan(PtList list, const ListElem **ptElems, int *ptSize) {
+	if (list == NULL) return LIST_NULL;
+
+	*ptElems = list->elements;
+	*ptSize = list->size;
+
+	return LIST_OK;
+}
+
+ListIterator listIterate(PtList list) {
+	ListIterator iterator = { list, 0 };
+	return iterator;
+}
+
+bool listNext(ListIterator *iterator, const ListElem **ptElem) {
+	PtList list = iterator->list;
+	if (list == NULL || iterator->rank >= list->size) return false;
+
+	*ptElem = &list->elements[iterator->rank++];
+
+	return true;
+}
+
+int listFind(PtList list, ListElemKey key, int *ptRank) {
+	if (list == NULL) return LIST_NULL;
+	if (!list->indexValid && !rebuildIndex(list)) return LIST_NO_MEMORY;
+
+	unsigned int tag = hashKey(key);
+	int mask = list->indexSlots - 1;
+	int slot = tag & mask;
+
+	while (list->index[slot].rank != -1) {
+		int rank = list->index[slot].rank;
+		if (list->index[slot].tag == tag && listElemKey(list->elements[rank]) == key) {
+			*ptRank = rank;
+			return LIST_OK;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return LIST_UNKNOWN_KEY;
+}
+
 int listSize(PtList list, int *ptSize) {
 	if (list == NULL) return LIST_NULL;
 
@@ -138,7 +390,10 @@ bool listIsEmpty(PtList list) {
 int listClear(PtList list) {
 	if (list == NULL) return LIST_NULL;
 
+	/* emptied first, so that a shared array is not copied */
 	list->size = 0;
+	if (!ownElements(list)) return LIST_NO_MEMORY;
+	rebuildIndex(list);
 
 	return LIST_OK;
 }
@@ -11,5 +11,10 @@
 
 void listElemPrint(ListElem elem)
 {
-	patientFullPrint(elem);
-}
\ No newline at end of file
+	patientFullPrint(elem, NULL); /* an element doesn't know its dictionaries */
+}
+
+ListElemKey listElemKey(ListElem elem)
+{
+	return elem.id;
+}
@@ -16,6 +16,9 @@
 /** Type definition. Change according to the use-case. */
 typedef Patient ListElem;
 
+/** Type of the key the list indexes its elements by. Change according to the use-case. */
+typedef long int ListElemKey;
+
 /**
  * @brief Prints an element.
  * 
@@ -24,4 +27,17 @@ typedef Patient ListElem;
  * 
  * @param elem [in] element to print
  */
-void listElemPrint(ListElem elem);
\ No newline at end of file
+void listElemPrint(ListElem elem);
+
+/**
+ * @brief Retrieves the key of an element.
+ * 
+ * The list keeps a hash index of its elements by this key,
+ * which is used by listFind.
+ * Must be implemented according to type
+ * of defined for ListElem.
+ * 
+ * @param elem [in] element
+ * @return the key of the element
+ */
+ListElemKey listElemKey(ListElem elem);
@@ -12,6 +12,9 @@
 #include "regionCommands.h"
 #include "patientCommands.h"
 #include "mixedCommands.h"
+#include "snapshot.h"
+#include "workerPool.h"
+#include "predicate.h"
 
 typedef char String[255];
 
@@ -24,6 +27,14 @@ typedef char String[255];
  * @return 0 if the strings are not equal.
  */
 int equalsStringIgnoreCase(char str1[], char str2[]);
+/**
+ * @brief Splits a command from its WHERE clause, if it has one (e.g., <b>SEX WHERE region = Seoul</b>).
+ * 
+ * @param command [in] The command, which is cut right before " WHERE ", ignoring capitalization.
+ * @return The condition of the clause or,
+ * @return NULL if the command has no WHERE clause.
+ */
+char *splitWhereClause(char command[]);
 /**
  * @brief Prints a menu containing an assortment of different commands for the user to choose from.
  * 
@@ -52,6 +63,7 @@ int main(int argc, char **argv)
 {
 	PtList patientsList = NULL;
 	PtMap regionsMap = NULL;
+	PtPatientStore patientStore = NULL; //Columnar copy of patientsList, rebuilt whenever the patients are (re)loaded.
 
 	Date mostRecentConfirmedDate = dateCreate(11, 11, 1111); //Default date value, will be changed after importing patients.
 
@@ -69,6 +81,37 @@ int main(int argc, char **argv)
 		fgets(command, sizeof(command), stdin);
 		command[strlen(command) - 1] = '\0';
 
+		//A WHERE clause restricts AVERAGE, SEX, MATRIX, TOP5 and GROUPBY to the patients that match its condition.
+		Selection selection;
+		Selection *filter = NULL;
+		char *condition = splitWhereClause(command);
+		if (condition != NULL)
+		{
+			if (!equalsStringIgnoreCase(command, "AVERAGE") && !equalsStringIgnoreCase(command, "SEX") && !equalsStringIgnoreCase(command, "MATRIX") &&
+				!equalsStringIgnoreCase(command, "TOP5") && !equalsStringIgnoreCase(command, "GROUPBY"))
+			{
+				printf("\nWHERE can only be used with AVERAGE, SEX, MATRIX, TOP5 and GROUPBY.\n");
+				continue;
+			}
+			if (!listIsEmpty(patientsList) && patientStore != NULL)
+			{
+				Predicate predicate;
+				char error[128];
+				if (!predicateCompile(patientStore, condition, &predicate, error, sizeof(error)))
+				{
+					printf("\nInvalid condition: %s\n", error);
+					continue;
+				}
+				if (!predicateSelect(patientStore, &predicate, &selection))
+				{
+					printf("\nOperation failure: Unable to evaluate the condition. Please try again!\n");
+					continue;
+				}
+				filter = &selection;
+				printf("\n%d of %d patients match the condition.\n", selection.count, selection.size);
+			}
+		}
+
 		if (equalsStringIgnoreCase(command, "QUIT"))
 		{
 			quit = 1;
@@ -79,10 +122,21 @@ int main(int argc, char **argv)
 			fgets(fileName, sizeof(fileName), stdin);
 			fileName[strlen(fileName) - 1] = '\0';
 
-			int error_code = importPatientsFromFile(fileName, &patientsList, &numberOfPatientsReadFromFile, &mostRecentConfirmedDate);
+			PatientDictionaries dictionaries;
+			int error_code = importPatientsFromFile(fileName, &patientsList, &dictionaries, &numberOfPatientsReadFromFile, &mostRecentConfirmedDate);
+			if (error_code != FILE_NOT_FOUND)
+			{
+				patientStoreDestroy(&patientStore);
+				patientStore = patientStoreCreate(patientsList, &dictionaries);
+			}
 			if (!listIsEmpty(patientsList) && error_code == FILE_OK)
 			{
 				printf("\n%d patients were read from %s\n", numberOfPatientsReadFromFile, fileName);
+				showStoreMemory(patientStore);
+			}
+			if (error_code != FILE_NOT_FOUND)
+			{
+				linkPatientsToRegions(patientStore, regionsMap);
 			}
 		}
 		else if (equalsStringIgnoreCase(command, "LOADR"))
@@ -97,21 +151,91 @@ int main(int argc, char **argv)
 			{
 				printf("\n%d regions were read from %s\n", numberOfRegionsReadFromFile, fileName);
 			}
+			linkPatientsToRegions(patientStore, regionsMap);
 		}
 		else if (equalsStringIgnoreCase(command, "CLEAR"))
 		{
-			mapClear(regionsMap);
-			listClear(patientsList);
+			//The memory of the dataset is given back, rather than kept as spare capacity.
+			mapDestroy(&regionsMap);
+			listDestroy(&patientsList);
+			patientStoreDestroy(&patientStore);
 			printf("\n%d region records deleted.", numberOfRegionsReadFromFile);
 			printf("\n%d patient records deleted.\n", numberOfPatientsReadFromFile);
 			numberOfPatientsReadFromFile = 0; //to reset the number of patients read from the file variable after clearing
 			numberOfRegionsReadFromFile = 0;  //same thing as above, but for the regions
 		}
+		else if (equalsStringIgnoreCase(command, "SAVE"))
+		{
+			if (listIsEmpty(patientsList) && mapIsEmpty(regionsMap))
+			{
+				printf("\nNo records were found! Please make sure you've imported the patients' or the regions' file before proceeding.\n");
+			}
+			else
+			{
+				printf("Insert filename> ");
+				fgets(fileName, sizeof(fileName), stdin);
+				fileName[strlen(fileName) - 1] = '\0';
+
+				int error_code = snapshotSave(fileName, patientsList, patientStore, regionsMap, mostRecentConfirmedDate);
+
+				if (error_code == SNAPSHOT_OK)
+				{
+					printf("\n%d patients and %d regions were saved to %s\n", numberOfPatientsReadFromFile, numberOfRegionsReadFromFile, fileName);
+				}
+				else
+				{
+					printf("\nOperation failure: Unable to save snapshot to %s. Please try again!\n", fileName);
+				}
+			}
+		}
+		else if (equalsStringIgnoreCase(command, "OPEN"))
+		{
+			printf("Insert filename> ");
+			fgets(fileName, sizeof(fileName), stdin);
+			fileName[strlen(fileName) - 1] = '\0';
+
+			PtList openedPatientsList = NULL;
+			PtPatientStore openedPatientStore = NULL;
+			PtMap openedRegionsMap = NULL;
+			int numberOfPatientsOpened = 0;
+			int numberOfRegionsOpened = 0;
+			Date openedMostRecentConfirmedDate;
+
+			int error_code = snapshotOpen(fileName, &openedPatientsList, &openedPatientStore, &openedRegionsMap, &numberOfPatientsOpened, &numberOfRegionsOpened, &openedMostRecentConfirmedDate);
+
+			if (error_code == SNAPSHOT_OK)
+			{
+				listDestroy(&patientsList);
+				mapDestroy(&regionsMap);
+				patientsList = openedPatientsList;
+				regionsMap = openedRegionsMap;
+				numberOfPatientsReadFromFile = numberOfPatientsOpened;
+				numberOfRegionsReadFromFile = numberOfRegionsOpened;
+				mostRecentConfirmedDate = openedMostRecentConfirmedDate;
+				patientStoreDestroy(&patientStore);
+				patientStore = openedPatientStore; //Already linked to the regions of the snapshot
+				printf("\n%d patients and %d regions were read from %s\n", numberOfPatientsOpened, numberOfRegionsOpened, fileName);
+				showStoreMemory(patientStore);
+				showPatientsWithoutRegion(patientStore, regionsMap);
+			}
+			else if (error_code == SNAPSHOT_FILE_NOT_FOUND)
+			{
+				printf("File not found (%s).\n", fileName);
+			}
+			else if (error_code == SNAPSHOT_INVALID_FORMAT)
+			{
+				printf("\n%s is not a valid snapshot, or was saved by an incompatible version of the program.\n", fileName);
+			}
+			else
+			{
+				printf("\nOperation failure: Unable to open snapshot. Please try again!\n");
+			}
+		}
 		else if (equalsStringIgnoreCase(command, "AVERAGE"))
 		{
 			if (!listIsEmpty(patientsList))
 			{
-				int error_code = average(patientsList);
+				int error_code = average(patientStore, filter);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -132,7 +256,7 @@ int main(int argc, char **argv)
 				scanf("%ld", &patientID);
 				getchar();
 				printf("\nFollowing Patient : ");
-				int error_code = follow(patientsList, patientID);
+				int error_code = follow(patientsList, patientStore, patientID);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -144,11 +268,32 @@ int main(int argc, char **argv)
 				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
 			}
 		}
+		else if (equalsStringIgnoreCase(command, "INFECTED"))
+		{
+			if (!listIsEmpty(patientsList))
+			{
+				long int patientID = 0;
+				printf("Insert an ID\nINFECTED> ");
+				scanf("%ld", &patientID);
+				getchar();
+				printf("\n");
+				int error_code = infected(patientsList, patientStore, patientID);
+
+				if (error_code == OPERATION_FAILURE)
+				{
+					printf("\nOperation failure: Unable to show the patients infected. Please try again!\n");
+				}
+			}
+			else
+			{
+				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
+			}
+		}
 		else if (equalsStringIgnoreCase(command, "SEX"))
 		{
 			if (!listIsEmpty(patientsList))
 			{
-				int error_code = sex(patientsList);
+				int error_code = sex(patientStore, filter);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -170,7 +315,7 @@ int main(int argc, char **argv)
 				scanf("%ld", &idOfPatientToShow);
 				getchar();
 				printf("\n");
-				int error_code = show(patientsList, idOfPatientToShow, mostRecentConfirmedDate);
+				int error_code = show(patientsList, patientStore, idOfPatientToShow, mostRecentConfirmedDate);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -186,7 +331,7 @@ int main(int argc, char **argv)
 		{
 			if (!listIsEmpty(patientsList))
 			{
-				int error_code = top5(patientsList);
+				int error_code = top5(patientsList, patientStore, filter);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -198,11 +343,34 @@ int main(int argc, char **argv)
 				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
 			}
 		}
+		else if (equalsStringIgnoreCase(command, "SPREADERS"))
+		{
+			if (!listIsEmpty(patientsList))
+			{
+				int patientsToDisplay = 0;
+				printf("Insert the number of patients to show\nSPREADERS> ");
+				scanf("%d", &patientsToDisplay);
+				getchar();
+
+				if (patientsToDisplay <= 0)
+				{
+					printf("\nThe number of patients to show must be positive.\n");
+				}
+				else if (spreaders(patientsList, patientStore, patientsToDisplay) == OPERATION_FAILURE)
+				{
+					printf("\nOperation failure: Unable to show spreaders. Please try again!\n");
+				}
+			}
+			else
+			{
+				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
+			}
+		}
 		else if (equalsStringIgnoreCase(command, "OLDEST"))
 		{
 			if (!listIsEmpty(patientsList))
 			{
-				int error_code = oldest(patientsList);
+				int error_code = oldest(patientsList, patientStore);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -220,11 +388,22 @@ int main(int argc, char **argv)
 			{
 				String growthDate;
 
-				printf("Please insert a date to show the growth rate (DD/MM/YYYY)\nGROWTH> ");
+				printf("Please insert a date, or a range of dates, to show the growth rate (DD/MM/YYYY or DD/MM/YYYY-DD/MM/YYYY)\nGROWTH> ");
 				fgets(growthDate, sizeof(growthDate), stdin);
 				growthDate[strlen(growthDate) - 1] = '\0';
 
-				int error_code = growth(patientsList, stringToDate(growthDate));
+				//A dash separates the first and the last date of a range.
+				char *lastDate = strchr(growthDate, '-');
+				int error_code;
+				if (lastDate != NULL)
+				{
+					*lastDate = '\0';
+					error_code = growthOverRange(patientStore, stringToDate(growthDate), stringToDate(lastDate + 1 + strspn(lastDate + 1, " ")));
+				}
+				else
+				{
+					error_code = growth(patientStore, stringToDate(growthDate));
+				}
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -240,7 +419,7 @@ int main(int argc, char **argv)
 		{
 			if (!listIsEmpty(patientsList))
 			{
-				int error_code = matrix(patientsList);
+				int error_code = matrix(patientStore, filter);
 
 				if (error_code == OPERATION_FAILURE)
 				{
@@ -252,6 +431,28 @@ int main(int argc, char **argv)
 				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
 			}
 		}
+		else if (equalsStringIgnoreCase(command, "GROUPBY"))
+		{
+			if (!listIsEmpty(patientsList))
+			{
+				String dimensionNames;
+
+				printf("Please insert 1 to 3 dimensions (sex, status, region, country, infection_case, age_band, confirmed_month)\nGROUPBY> ");
+				fgets(dimensionNames, sizeof(dimensionNames), stdin);
+				dimensionNames[strlen(dimensionNames) - 1] = '\0';
+
+				int error_code = groupBy(patientStore, dimensionNames, filter);
+
+				if (error_code == OPERATION_FAILURE)
+				{
+					printf("\nOperation failure: Unable to show groups. Please try again!\n");
+				}
+			}
+			else
+			{
+				printf("\nNo patient records were found! Please make sure you've correctly imported the patients' file before proceeding.\n");
+			}
+		}
 		else if (equalsStringIgnoreCase(command, "REGIONS"))
 		{
 			if (listIsEmpty(patientsList) && mapIsEmpty(regionsMap))
@@ -262,7 +463,7 @@ int main(int argc, char **argv)
 			{
 				if (!mapIsEmpty(regionsMap))
 				{
-					int error_code = regions(patientsList, regionsMap);
+					int error_code = regions(patientStore, regionsMap);
 
 					if (error_code == OPERATION_FAILURE)
 					{
@@ -289,7 +490,7 @@ int main(int argc, char **argv)
 			{
 				if (!mapIsEmpty(regionsMap))
 				{
-					int error_code = report(patientsList, regionsMap);
+					int error_code = report(patientStore, regionsMap);
 
 					if (error_code == OPERATION_SUCCESS)
 					{
@@ -314,10 +515,17 @@ int main(int argc, char **argv)
 		{
 			printf("%s : Command not found.\n", command);
 		}
+
+		if (filter != NULL)
+		{
+			selectionDestroy(filter);
+		}
 	}
 
 	listDestroy(&patientsList);
 	mapDestroy(&regionsMap);
+	patientStoreDestroy(&patientStore);
+	workerPoolSharedDestroy();
 	printf("\nThank you for using the program. See you next time!\n\n");
 
 	return (EXIT_SUCCESS);
@@ -326,14 +534,30 @@ int equalsStringIgnoreCase(char str1[], char str2[])
 {
 	return (strcasecmp(str1, str2) == 0);
 }
+char *splitWhereClause(char command[])
+{
+	for (int i = 0; command[i] != '\0'; i++)
+	{
+		if (strncasecmp(&command[i], " WHERE ", 7) == 0)
+		{
+			char *condition = &command[i + 7];
+			for (command[i] = '\0'; i > 0 && command[i - 1] == ' '; i--)
+			{
+				command[i - 1] = '\0';
+			}
+			return condition;
+		}
+	}
+	return NULL;
+}
 void printCommandsMenu()
 {
 	printf("\n===================================================================================");
 	printf("\n                          PROJECT: COVID-19                    ");
 	printf("\n===================================================================================");
-	printf("\nA. Base Commands (LOADP, LOADR, CLEAR).");
-	printf("\nB. Simple Indicators and searchs (AVERAGE, FOLLOW, MATRIX, OLDEST, GROWTH, SEX, SHOW, TOP5).");
-	printf("\nC. Advanced indicator (REGIONS, REPORT)");
+	printf("\nA. Base Commands (LOADP, LOADR, CLEAR, SAVE, OPEN).");
+	printf("\nB. Simple Indicators and searchs (AVERAGE, FOLLOW, INFECTED, MATRIX, OLDEST, GROWTH, SEX, SHOW, SPREADERS, TOP5).");
+	printf("\nC. Advanced indicator (GROUPBY, REGIONS, REPORT)");
 	printf("\nD. Exit (QUIT)\n\n");
 	printf("COMMAND> ");
 }
@@ -353,8 +577,15 @@ void testPatient()
 	Date date1 = dateCreate(11, 11, 1995);
 	Date date2 = dateCreate(12, 12, 1996);
 	Date date3 = dateCreate(14, 5, 1987);
-	Patient patient = patientCreate(123456789, "Male", 1995, "Portugal", "Setúbal", "Physical Contact", 45678913, date3, date2, date1, "Dead");
-	patientFullPrint(patient);
+	PatientDictionaries dictionaries;
+	if (patientDictionariesCreate(&dictionaries))
+	{
+		Patient patient = patientCreate(123456789, dictionaryIntern(dictionaries.sexes, "Male", 4), 1995, dictionaryIntern(dictionaries.countries, "Portugal", 8),
+										dictionaryIntern(dictionaries.regions, "Setúbal", strlen("Setúbal")), dictionaryIntern(dictionaries.infectionReasons, "Physical Contact", 16),
+										45678913, date3, date2, date1, dictionaryIntern(dictionaries.statuses, "Dead", 4));
+		patientFullPrint(patient, &dictionaries);
+	}
+	patientDictionariesDestroy(&dictionaries);
 	printf("\n===============================");
 }
 void testRegion()
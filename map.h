@@ -117,10 +117,12 @@ bool mapContains(PtMap map, MapKey key);
  * 
  * This function returns a dynamically allocated array
  * with length equal to the size of the map, containing
- * the keys of the map in no particular order.
+ * the keys of the map sorted by key (see mapKeyCompare).
  * 
  * The caller is responsible for deallocating 
- * (freeing) the array. 
+ * (freeing) the array. The contents of the keys belong
+ * to the map, and remain valid until it is cleared or
+ * destroyed.
  * 
  * @param map [in] pointer to the map
  * 
@@ -134,7 +136,7 @@ MapKey* mapKeys(PtMap map);
  * 
  * This function returns a dynamically allocated array
  * with length equal to the size of the map, containing
- * the values of the map in no particular order.
+ * the values of the map sorted by key (see mapKeyCompare).
  * 
  * The caller is responsible for deallocating 
  * (freeing) the array. 
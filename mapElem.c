@@ -8,10 +8,21 @@
 
 #include "mapElem.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+
+#define KEY_BLOCK_SIZE 4096
+
+struct mapKeyBlock {
+	struct mapKeyBlock *next;
+	int used;
+	int capacity;
+	char contents[];
+};
+
 void mapKeyPrint(MapKey key)
 {
-	printf("%s", key.contents);
+	printf("%.*s", key.length, key.contents);
 }
 
 void mapValuePrint(MapValue value)
@@ -21,17 +32,72 @@ void mapValuePrint(MapValue value)
 
 bool mapKeyEquals(MapKey key1, MapKey key2)
 {
-	return (strcmp(key1.contents, key2.contents) == 0);
+	return key1.hash == key2.hash && key1.length == key2.length 
+		&& memcmp(key1.contents, key2.contents, key1.length) == 0;
 }
 
 int mapKeyCompare(MapKey key1, MapKey key2)
 {
-	return (strcmp(key1.contents, key2.contents));
+	int length = key1.length < key2.length ? key1.length : key2.length;
+	int comparison = memcmp(key1.contents, key2.contents, length);
+
+	/* same order as strcmp: a key sorts after its prefixes */
+	return comparison != 0 ? comparison : key1.length - key2.length;
+}
+
+unsigned int mapKeyHash(MapKey key)
+{
+	return key.hash;
+}
+
+bool mapKeyStore(MapKeyArena *arena, MapKey key, MapKey *ptStoredKey)
+{
+	struct mapKeyBlock *block = arena->blocks;
+
+	if (block == NULL || block->capacity - block->used < key.length)
+	{
+		int capacity = key.length > KEY_BLOCK_SIZE ? key.length : KEY_BLOCK_SIZE;
+		block = (struct mapKeyBlock *)malloc(sizeof(struct mapKeyBlock) + capacity);
+		if (block == NULL)
+			return false;
+
+		block->next = arena->blocks;
+		block->used = 0;
+		block->capacity = capacity;
+		arena->blocks = block;
+	}
+
+	char *contents = block->contents + block->used;
+	memcpy(contents, key.contents, key.length);
+	block->used += key.length;
+
+	*ptStoredKey = key;
+	ptStoredKey->contents = contents;
+	return true;
+}
+
+void mapKeyArenaClear(MapKeyArena *arena)
+{
+	while (arena->blocks != NULL)
+	{
+		struct mapKeyBlock *next = arena->blocks->next;
+		free(arena->blocks);
+		arena->blocks = next;
+	}
 }
 
 KeyString mapKeyCreate(char *keyContents)
 {
 	KeyString key;
-	strcpy(key.contents, keyContents);
+	key.contents = keyContents;
+	key.length = strlen(keyContents);
+
+	/* FNV-1a */
+	key.hash = 2166136261u;
+	for (int i = 0; i < key.length; i++)
+	{
+		key.hash ^= (unsigned char)keyContents[i];
+		key.hash *= 16777619u;
+	}
 	return key;
 }
\ No newline at end of file
@@ -24,6 +24,18 @@ typedef KeyString MapKey;
 /** Value type definition. Change according to the use-case. */
 typedef Region MapValue;
 
+/** Block of storage of a key arena. */
+struct mapKeyBlock;
+
+/** 
+ * Holds the contents of the keys stored by a map, in blocks 
+ * that are never moved, so that stored keys remain valid
+ * until the arena is cleared. Zero-initialize before use.
+ */
+typedef struct mapKeyArena {
+	struct mapKeyBlock *blocks;
+} MapKeyArena;
+
 /**
  * @brief Prints a key.
  * 
@@ -64,4 +76,30 @@ bool mapKeyEquals(MapKey key1, MapKey key2);
  */
 int mapKeyCompare(MapKey key1, MapKey key2);
 
+/**
+ * @brief Retrieves the hash of a key.
+ * This function is used by hash table implementations 
+ * of the ADT Map. Keys that match must have the same hash.
+ * @param key [in] key to hash
+ * @return the hash of the key
+ */
+unsigned int mapKeyHash(MapKey key);
+
+/**
+ * @brief Copies the contents of a key to a key arena.
+ * This function is used by the ADT Map when it stores
+ * a new key, so that the map owns the contents of its keys.
+ * @param arena [in] pointer to the arena of the map
+ * @param key [in] key to copy
+ * @param ptStoredKey [out] address of variable to hold the copy
+ * @return 'true' if the key was copied, or
+ * @return 'false' if unsufficient memory for allocation
+ */
+bool mapKeyStore(MapKeyArena *arena, MapKey key, MapKey *ptStoredKey);
 
+/**
+ * @brief Frees the contents of all keys of a key arena.
+ * Keys stored in the arena are no longer valid afterwards.
+ * @param arena [in] pointer to the arena
+ */
+void mapKeyArenaClear(MapKeyArena *arena);
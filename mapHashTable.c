@@ -0,0 +1,401 @@
+/**
+ * @file mapHashTable.c
+ *
+ * @brief Provides an implementation of the ADT Map with an open-addressing
+ * hash table as the underlying data structure.
+ * The entries are kept in a dense array list, in no particular order, and
+ * indexed by a table of slots with linear probing. Each slot caches the hash
+ * of its key, so that probing doesn't touch the entries and keys are only
+ * compared when their hashes match.
+ * mapKeys and mapValues sort the entries on demand, so they return them
+ * sorted by key, like the sorted array list implementation.
+ * @author Bruno Silva (brunomnsilva@gmail.com)
+ * @bug No known bugs.
+ */
+
+#include "map.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define SLOT_EMPTY   -1
+#define SLOT_DELETED -2
+
+typedef struct keyValue
+{
+	MapKey key;
+	MapValue value;
+} KeyValue;
+
+typedef struct slot
+{
+	unsigned int hash;
+	int index;	/* index of the entry in 'elements', or SLOT_EMPTY or SLOT_DELETED */
+} Slot;
+
+typedef struct mapImpl
+{
+	KeyValue *elements;
+	int capacity;
+	int size;
+	MapKeyArena keyArena;	/* contents of the keys */
+	Slot *slots;
+	int slotCount;	/* power of two, at least twice the number of used slots */
+	int usedSlots;	/* slots holding an entry or a deleted mark */
+} MapImpl;
+
+/**
+ * @brief Auxiliary function to find the slot of a key.
+ *
+ * @param map [in] pointer to the map
+ * @param key [in] key to find
+ * @param hash [in] hash of the key
+ * @return index of the slot holding 'key', or
+ * @return -1 if no slot holds 'key'
+ */
+static int findSlotOfKey(PtMap map, MapKey key, unsigned int hash)
+{
+	int mask = map->slotCount - 1;
+	int slot = hash & mask;
+
+	while (map->slots[slot].index != SLOT_EMPTY)
+	{
+		int index = map->slots[slot].index;
+		if (index != SLOT_DELETED && map->slots[slot].hash == hash && mapKeyEquals(map->elements[index].key, key))
+			return slot;
+		slot = (slot + 1) & mask;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Auxiliary function to index an entry in the first free slot of its probe sequence.
+ *
+ * @param map [in] pointer to the map
+ * @param index [in] index of the entry in 'elements'
+ */
+static void insertSlot(PtMap map, int index)
+{
+	unsigned int hash = mapKeyHash(map->elements[index].key);
+	int mask = map->slotCount - 1;
+	int slot = hash & mask;
+
+	while (map->slots[slot].index >= 0)
+		slot = (slot + 1) & mask;
+
+	if (map->slots[slot].index == SLOT_EMPTY)
+		map->usedSlots++;
+
+	map->slots[slot].hash = hash;
+	map->slots[slot].index = index;
+}
+
+/**
+ * @brief Auxiliary function to rebuild the table of slots, with enough slots
+ * for the capacity of the map. This also discards the deleted marks.
+ *
+ * @param map [in] pointer to the map
+ * @return true if the table was rebuilt, or
+ * @return false if unsufficient memory for allocation
+ */
+static bool rehash(PtMap map)
+{
+	int slotCount = 16;
+	while (slotCount < 2 * map->capacity)
+		slotCount *= 2;
+
+	Slot *newSlots = (Slot *)malloc(slotCount * sizeof(Slot));
+	if (newSlots == NULL)
+		return false;
+
+	free(map->slots);
+	map->slots = newSlots;
+	map->slotCount = slotCount;
+	map->usedSlots = 0;
+
+	for (int i = 0; i < slotCount; i++)
+		map->slots[i].index = SLOT_EMPTY;
+	for (int i = 0; i < map->size; i++)
+		insertSlot(map, i);
+
+	return true;
+}
+
+static bool ensureCapacity(PtMap map)
+{
+	if (map->size == map->capacity)
+	{
+		int newCapacity = map->capacity > 0 ? map->capacity * 2 : 1;
+		KeyValue *newArray = (KeyValue *)realloc(map->elements,
+												 newCapacity * sizeof(KeyValue));
+
+		if (newArray == NULL)
+			return false;
+
+		map->elements = newArray;
+		map->capacity = newCapacity;
+	}
+
+	/* keep at least half of the slots empty, so that probe sequences stay short */
+	if (2 * (map->usedSlots + 1) > map->slotCount)
+		return rehash(map);
+
+	return true;
+}
+
+/**
+ * @brief Auxiliary function to compare two entries by key, for qsort.
+ *
+ * @param entry1 [in] pointer to a pointer to an entry
+ * @param entry2 [in] pointer to another pointer to an entry
+ * @return the result of mapKeyCompare on the keys of the entries
+ */
+static int compareEntries(const void *entry1, const void *entry2)
+{
+	const KeyValue *keyValue1 = *(const KeyValue **)entry1;
+	const KeyValue *keyValue2 = *(const KeyValue **)entry2;
+
+	return mapKeyCompare(keyValue1->key, keyValue2->key);
+}
+
+/**
+ * @brief Auxiliary function to retrieve the entries of a map sorted by key.
+ *
+ * The caller is responsible for deallocating (freeing) the array.
+ *
+ * @param map [in] pointer to a non-empty map
+ * @return array of pointers to the entries, or
+ * @return NULL if unsufficient memory for allocation
+ */
+static KeyValue **sortedEntries(PtMap map)
+{
+	KeyValue **entries = (KeyValue **)malloc(map->size * sizeof(KeyValue *));
+	if (entries == NULL)
+		return NULL;
+
+	for (int i = 0; i < map->size; i++)
+		entries[i] = &map->elements[i];
+
+	qsort(entries, map->size, sizeof(KeyValue *), compareEntries);
+
+	return entries;
+}
+
+PtMap mapCreate(unsigned int initialCapacity)
+{
+	PtMap newMap = (PtMap)malloc(sizeof(MapImpl));
+	if (newMap == NULL)
+		return NULL;
+
+	newMap->elements = (KeyValue *)calloc(initialCapacity > 0 ? initialCapacity : 1, sizeof(KeyValue));
+	if (newMap->elements == NULL)
+	{
+		free(newMap);
+		return NULL;
+	}
+
+	newMap->size = 0;
+	newMap->keyArena.blocks = NULL;
+	newMap->capacity = initialCapacity > 0 ? initialCapacity : 1;
+	newMap->slots = NULL;
+
+	if (!rehash(newMap))
+	{
+		free(newMap->elements);
+		free(newMap);
+		return NULL;
+	}
+
+	return newMap;
+}
+
+int mapDestroy(PtMap *ptMap)
+{
+	PtMap map = *ptMap;
+
+	if (map == NULL)
+		return MAP_NULL;
+
+	free(map->elements);
+	mapKeyArenaClear(&map->keyArena);
+	free(map->slots);
+	free(map);
+
+	*ptMap = NULL;
+
+	return MAP_OK;
+}
+
+int mapSize(PtMap map, int *ptSize)
+{
+	if (map == NULL)
+		return MAP_NULL;
+	*ptSize = map->size;
+	return MAP_OK;
+}
+
+bool mapIsEmpty(PtMap map)
+{
+	if (map == NULL)
+		return 1;
+	return (map->size == 0);
+}
+
+int mapClear(PtMap map)
+{
+	if (map == NULL)
+		return MAP_NULL;
+
+	mapKeyArenaClear(&map->keyArena);
+	for (int i = 0; i < map->slotCount; i++)
+		map->slots[i].index = SLOT_EMPTY;
+
+	map->size = 0;
+	map->usedSlots = 0;
+	return MAP_OK;
+}
+
+void mapPrint(PtMap map)
+{
+	if (map == NULL)
+	{
+		printf("(MAP NULL)\n");
+	}
+	else if (mapIsEmpty(map))
+	{
+		printf("(MAP EMPTY)\n");
+	}
+	else
+	{
+		for (int i = 0; i < map->size; i++)
+		{	printf("\n");
+			mapKeyPrint(map->elements[i].key);
+			printf(":\n");
+			mapValuePrint(map->elements[i].value);
+		}
+	}
+}
+
+int mapPut(PtMap map, MapKey key, MapValue value)
+{
+	if (map == NULL)
+		return MAP_NULL;
+
+	unsigned int hash = mapKeyHash(key);
+	int slot = findSlotOfKey(map, key, hash);
+	if (slot != -1)
+	{
+		map->elements[map->slots[slot].index].value = value;
+		return MAP_OK;
+	}
+
+	if (!ensureCapacity(map) || !mapKeyStore(&map->keyArena, key, &key))
+		return MAP_NO_MEMORY;
+
+	map->elements[map->size].key = key;
+	map->elements[map->size].value = value;
+	insertSlot(map, map->size);
+	map->size++;
+
+	return MAP_OK;
+}
+
+int mapRemove(PtMap map, MapKey key, MapValue *ptValue)
+{
+	if (map == NULL)
+		return MAP_NULL;
+	if (map->size == 0)
+		return MAP_EMPTY;
+
+	unsigned int hash = mapKeyHash(key);
+	int slot = findSlotOfKey(map, key, hash);
+	if (slot == -1)
+		return MAP_UNKNOWN_KEY;
+
+	int index = map->slots[slot].index;
+	*ptValue = map->elements[index].value;
+	map->slots[slot].index = SLOT_DELETED;
+
+	/* move the last entry into the gap, and point its slot to the new index */
+	int last = map->size - 1;
+	if (index != last)
+	{
+		int lastSlot = findSlotOfKey(map, map->elements[last].key, mapKeyHash(map->elements[last].key));
+		map->elements[index] = map->elements[last];
+		map->slots[lastSlot].index = index;
+	}
+
+	map->size--;
+
+	return MAP_OK;
+}
+
+bool mapContains(PtMap map, MapKey key)
+{
+	if (map == NULL)
+		return 0;
+
+	return findSlotOfKey(map, key, mapKeyHash(key)) != -1;
+}
+
+int mapGet(PtMap map, MapKey key, MapValue *ptValue)
+{
+	if (map == NULL)
+		return MAP_NULL;
+	if (map->size == 0)
+		return MAP_EMPTY;
+
+	int slot = findSlotOfKey(map, key, mapKeyHash(key));
+	if (slot == -1)
+		return MAP_UNKNOWN_KEY;
+
+	*ptValue = map->elements[map->slots[slot].index].value;
+
+	return MAP_OK;
+}
+
+MapKey *mapKeys(PtMap map)
+{
+	if (map == NULL || map->size == 0)
+		return NULL;
+
+	KeyValue **entries = sortedEntries(map);
+	MapKey *keys = (MapKey *)calloc(map->size, sizeof(MapKey));
+	if (entries == NULL || keys == NULL)
+	{
+		free(entries);
+		free(keys);
+		return NULL;
+	}
+
+	for (int i = 0; i < map->size; i++)
+	{
+		keys[i] = entries[i]->key;
+	}
+
+	free(entries);
+	return keys;
+}
+
+MapValue *mapValues(PtMap map)
+{
+	if (map == NULL || map->size == 0)
+		return NULL;
+
+	KeyValue **entries = sortedEntries(map);
+	MapValue *values = (MapValue *)calloc(map->size, sizeof(MapValue));
+	if (entries == NULL || values == NULL)
+	{
+		free(entries);
+		free(values);
+		return NULL;
+	}
+
+	for (int i = 0; i < map->size; i++)
+	{
+		values[i] = entries[i]->value;
+	}
+
+	free(entries);
+	return values;
+}
@@ -23,6 +23,7 @@ typedef struct mapImpl
 	KeyValue *elements;
 	int capacity;
 	int size;
+	MapKeyArena keyArena;	/* contents of the keys */
 } MapImpl;
 
 /**
@@ -65,7 +66,7 @@ int findIndexOfKey(PtMap map, MapKey key)
 	if (map == NULL)
 		return -1;
 
-	return findIndexOfKeyBinary(map, key, 0, map->size);
+	return findIndexOfKeyBinary(map, key, 0, map->size - 1);
 }
 
 static bool ensureCapacity(PtMap map)
@@ -100,6 +101,7 @@ PtMap mapCreate(unsigned int initialCapacity)
 	}
 
 	newMap->size = 0;
+	newMap->keyArena.blocks = NULL;
 	newMap->capacity = initialCapacity;
 
 	return newMap;
@@ -113,6 +115,7 @@ int mapDestroy(PtMap *ptMap)
 		return MAP_NULL;
 
 	free(map->elements);
+	mapKeyArenaClear(&map->keyArena);
 	free(map);
 
 	*ptMap = NULL;
@@ -140,6 +143,7 @@ int mapClear(PtMap map)
 	if (map == NULL)
 		return MAP_NULL;
 	map->size = 0;
+	mapKeyArenaClear(&map->keyArena);
 	return MAP_OK;
 }
 
@@ -173,21 +177,25 @@ int mapPut(PtMap map, MapKey key, MapValue value)
 	if (index != -1)
 	{
 		map->elements[index].value = value;
+		return MAP_OK;
 	}
 	else
 	{
 		if (!ensureCapacity(map))
 			return MAP_FULL;
+		if (!mapKeyStore(&map->keyArena, key, &key))
+			return MAP_NO_MEMORY;
 
-		int indexInsert = map->size;
-
-		for (int i = 0; i < map->size; i++)
+		/* binary search for the first key larger than 'key' */
+		int indexInsert = 0;
+		int end = map->size;
+		while (indexInsert < end)
 		{
-			if (mapKeyCompare(map->elements[i].key, key) > 0)
-			{
-				indexInsert = i;
-				break;
-			}
+			int middle = (indexInsert + end) / 2;
+			if (mapKeyCompare(map->elements[middle].key, key) > 0)
+				end = middle;
+			else
+				indexInsert = middle + 1;
 		}
 		for (int i = map->size; i > indexInsert; i--)
 		{
@@ -0,0 +1,56 @@
+/**
+ * @file mappedFile.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>MappedFile</i></b> data type
+ */
+
+#include "mappedFile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool mappedFileOpen(const char *filename, MappedFile *file)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1)
+    {
+        close(fd);
+        return false;
+    }
+
+    file->contents = NULL;
+    file->size = (size_t)info.st_size;
+
+    if (file->size > 0)
+    {
+        void *contents = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (contents == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        madvise(contents, file->size, MADV_SEQUENTIAL);
+        file->contents = contents;
+    }
+
+    //The mapping stays valid after the descriptor is closed.
+    close(fd);
+    return true;
+}
+
+void mappedFileClose(MappedFile *file)
+{
+    if (file->contents != NULL)
+    {
+        munmap((void *)file->contents, file->size);
+    }
+    file->contents = NULL;
+    file->size = 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file mappedFile.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>MappedFile</i></b> and related operations.
+ * A mapped file gives read-only access to the whole contents of a file through a memory mapping, so that its contents can be parsed in place.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Represents a file mapped into memory.
+ * 
+ */
+typedef struct mappedFile
+{
+    const char *contents;
+    size_t size;
+} MappedFile;
+
+/**
+ * @brief Maps the whole contents of a file into memory for reading.
+ * 
+ * @param filename [in] The name of the file
+ * @param file [out] The mapped file. Empty files are mapped with NULL contents and a size of 0
+ * @return true if the file was successfully opened and mapped or,
+ * @return false if the file could not be opened or mapped
+ */
+bool mappedFileOpen(const char *filename, MappedFile *file);
+
+/**
+ * @brief Unmaps a file previously mapped with mappedFileOpen.
+ * 
+ * @param file [in] The mapped file
+ */
+void mappedFileClose(MappedFile *file);
@@ -9,36 +9,31 @@
 #include <string.h>
 #include <stdlib.h>
 
-int regions(PtList patientsList, PtMap regionsMap)
+int regions(PtPatientStore patientStore, PtMap regionsMap)
 {
-    if (patientsList == NULL || regionsMap == NULL)
+    if (patientStore == NULL || regionsMap == NULL)
         return OPERATION_FAILURE;
 
-    int sizeOfRegionsMap = 0;
-    mapSize(regionsMap, &sizeOfRegionsMap);
-
-    PtMap mapOfRegionsStillInfected = mapCreate(sizeOfRegionsMap);
-    fillMapOfRegionsStillInfected(patientsList, regionsMap, mapOfRegionsStillInfected);
-
-    int sizeOfMapOfStillInfected = 0;
-    mapSize(mapOfRegionsStillInfected, &sizeOfMapOfStillInfected);
+    int *regionIds = (int *)malloc((patientStore->regionCount > 0 ? patientStore->regionCount : 1) * sizeof(int));
+    if (regionIds == NULL)
+        return OPERATION_FAILURE;
 
-    MapValue *values = mapValues(mapOfRegionsStillInfected);
+    //Region ids follow the order of the map, so the regions are shown in that order.
+    int numberOfRegionsStillInfected = findRegionsStillInfected(patientStore, regionIds);
 
-    for (int i = 0; i < sizeOfMapOfStillInfected; i++)
+    for (int i = 0; i < numberOfRegionsStillInfected; i++)
     {
-        mapValuePrint(values[i]);
+        mapValuePrint(patientStore->regionValues[regionIds[i]]);
         printf("\n");
     }
 
-    free(values);
-    mapDestroy(&mapOfRegionsStillInfected);
+    free(regionIds);
     return OPERATION_SUCCESS;
 }
 
-int report(PtList patientsList, PtMap regionsMap)
+int report(PtPatientStore patientStore, PtMap regionsMap)
 {
-    if (patientsList == NULL || regionsMap == NULL)
+    if (patientStore == NULL || regionsMap == NULL)
     {
         return OPERATION_FAILURE;
     }
@@ -63,9 +58,21 @@ int report(PtList patientsList, PtMap regionsMap)
     int sizeList = 0;
 
     mapSize(regionsMap, &sizeMap);
-    listSize(patientsList, &sizeList);
+    sizeList = patientStore->size;
 
-    bool countryHasPopulation = calculateCountryStatistics(patientsList, regionsMap, "Korea", &countryLethality, &countryIncidentRate, &countryMortalityRate, sizeList, sizeMap);
+    //The deaths and infections of every region and of the country are counted at once, then looked up by region id.
+    OutcomeCounts countryCounts;
+    OutcomeCounts *regionCounts = countOutcomesByRegion(patientStore, "Korea", &countryCounts);
+    if (regionCounts == NULL)
+    {
+        fclose(reportFile);
+        return OPERATION_FAILURE;
+    }
+
+    MapValue korea;
+    int populationOfKorea = mapGet(regionsMap, mapKeyCreate("South Korea"), &korea) == MAP_OK ? korea.population : 0;
+
+    bool countryHasPopulation = calculateOutcomeStatistics(countryCounts, populationOfKorea, sizeList, &countryLethality, &countryIncidentRate, &countryMortalityRate);
     if (!countryHasPopulation)
     {
         fprintf(reportFile, "%s unknown (no population data)", "Korea");
@@ -77,13 +84,13 @@ int report(PtList patientsList, PtMap regionsMap)
         fprintf(reportFile, "\n\n");
     }
 
-    MapValue *values = mapValues(regionsMap);
+    MapValue *values = patientStore->regionValues;
 
-    for (int i = 0; i < sizeMap; i++)
+    for (int i = 0; i < patientStore->regionCount; i++)
     {
         if (!(strcmp(values[i].name, "South Korea") == 0))
         {
-            bool hasPopulation = calculateRegionStatistics(patientsList, regionsMap, values[i].name, &regionLethality, &regionIncidentRate, &regionMortalityRate, sizeList, sizeMap);
+            bool hasPopulation = calculateOutcomeStatistics(regionCounts[i], values[i].population, sizeList, &regionLethality, &regionIncidentRate, &regionMortalityRate);
             if (!hasPopulation)
             {
                 fprintf(reportFile, "%s unknown (no population data)", values[i].name);
@@ -96,7 +103,30 @@ int report(PtList patientsList, PtMap regionsMap)
         }
     }
 
+    free(regionCounts);
     fclose(reportFile);
-    free(values);
     return OPERATION_SUCCESS;
+}
+
+void linkPatientsToRegions(PtPatientStore patientStore, PtMap regionsMap)
+{
+    if (patientStore == NULL)
+        return;
+
+    if (!patientStoreLinkRegions(patientStore, regionsMap))
+    {
+        printf("\nOperation failure: Unable to link the patients to their regions.\n");
+    }
+    else
+    {
+        showPatientsWithoutRegion(patientStore, regionsMap);
+    }
+}
+
+void showPatientsWithoutRegion(PtPatientStore patientStore, PtMap regionsMap)
+{
+    if (patientStore != NULL && !mapIsEmpty(regionsMap) && patientStore->patientsWithoutRegion > 0)
+    {
+        printf("\n%d patients belong to a region missing from the regions' file.\n", patientStore->patientsWithoutRegion);
+    }
 }
\ No newline at end of file
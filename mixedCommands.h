@@ -14,20 +14,37 @@
 /**
  * @brief Shows the regions that still have active COVID-19 cases.
  * 
- * @param patientsList [in] A list of patients. 
- * It will be from this list that we retrieve the information about which patients are still sick.
+ * @param patientStore [in] A columnar store of patients. 
+ * It will be from this store that we retrieve the information about which patients are still sick.
  * @param regionsMap [in] A map of regions. 
  * @return OPERATION_SUCCESS If the regions are able to be shown
- * @return OPERATION_FAILURE If the either the list or the map are NULL
+ * @return OPERATION_FAILURE If the either the store or the map are NULL
  */
-int regions(PtList patientsList, PtMap regionsMap);
+int regions(PtPatientStore patientStore, PtMap regionsMap);
 
 /**
  * @brief Creates a report containing information about the following percentages: Mortality | Incidence Rate | Lethality.
  * 
- * @param patientsList [in] A list of patients.
+ * @param patientStore [in] A columnar store of patients.
  * @param regionsMap [in] A map of regions.p 
  * @return OPERATION_SUCCESS If the file is sucessfully created with all the data in it
- * @return OPERATION_FAILURE If the either the list or the map are NULL or the if the file was not successfully created
+ * @return OPERATION_FAILURE If the either the store or the map are NULL or the if the file was not successfully created
  */
-int report(PtList patientsList, PtMap regionsMap);
\ No newline at end of file
+int report(PtPatientStore patientStore, PtMap regionsMap);
+
+/**
+ * @brief Links the patients to their regions (see patientStoreLinkRegions), reporting how many patients belong to a region missing from the map of regions.
+ * Must be called whenever either the patients or the regions are (re)loaded.
+ * 
+ * @param patientStore [in] A columnar store of patients. Nothing happens if it is NULL
+ * @param regionsMap [in] A map of regions
+ */
+void linkPatientsToRegions(PtPatientStore patientStore, PtMap regionsMap);
+
+/**
+ * @brief Reports how many patients of a store already linked to its regions belong to a region missing from the map of regions, if any.
+ * 
+ * @param patientStore [in] A columnar store of patients. Nothing happens if it is NULL
+ * @param regionsMap [in] The map of regions the store is linked to
+ */
+void showPatientsWithoutRegion(PtPatientStore patientStore, PtMap regionsMap);
\ No newline at end of file
@@ -8,8 +8,29 @@
 #include <stdio.h>
 #include <string.h>
 
-Patient patientCreate(long int id, char *sex, int birthYear, char *country, char *region, char *infectionReason,
-                      long int infectedBy, Date confirmedDate, Date releasedDate, Date deceasedDate, char *status)
+bool patientDictionariesCreate(PatientDictionaries *dictionaries)
+{
+    dictionaries->sexes = dictionaryCreate(4);
+    dictionaries->countries = dictionaryCreate(16);
+    dictionaries->regions = dictionaryCreate(64);
+    dictionaries->infectionReasons = dictionaryCreate(64);
+    dictionaries->statuses = dictionaryCreate(4);
+
+    return dictionaries->sexes != NULL && dictionaries->countries != NULL && dictionaries->regions != NULL &&
+           dictionaries->infectionReasons != NULL && dictionaries->statuses != NULL;
+}
+
+void patientDictionariesDestroy(PatientDictionaries *dictionaries)
+{
+    dictionaryDestroy(&dictionaries->sexes);
+    dictionaryDestroy(&dictionaries->countries);
+    dictionaryDestroy(&dictionaries->regions);
+    dictionaryDestroy(&dictionaries->infectionReasons);
+    dictionaryDestroy(&dictionaries->statuses);
+}
+
+Patient patientCreate(long int id, int sexCode, int birthYear, int countryCode, int regionCode, int infectionReasonCode,
+                      long int infectedBy, Date confirmedDate, Date releasedDate, Date deceasedDate, int statusCode)
 {
     Patient patient;
     patient.id = id;
@@ -18,20 +39,32 @@ Patient patientCreate(long int id, char *sex, int birthYear, char *country, char
     patient.confirmedDate = confirmedDate;
     patient.releasedDate = releasedDate;
     patient.deceasedDate = deceasedDate;
-    strcpy(patient.country, country);
-    strcpy(patient.sex, sex);
-    strcpy(patient.status, status);
-    strcpy(patient.region, region);
-    strcpy(patient.infectionReason, infectionReason);
+    patient.countryCode = countryCode;
+    patient.sexCode = sexCode;
+    patient.statusCode = statusCode;
+    patient.regionCode = regionCode;
+    patient.infectionReasonCode = infectionReasonCode;
 
     return patient;
 }
 
-void patientFullPrint(Patient patient)
+void patientFullPrint(Patient patient, const PatientDictionaries *dictionaries)
 {
     printf("\n=========================================");
-    printf("\nID: %ld \nBirth year: %d \nSex: %s \nCountry: %s \nRegion: %s \nStatus: %s \nInfection reason: %s\nInfected by: %ld \n",
-           patient.id, patient.birthYear, patient.sex, patient.country, patient.region, patient.status, patient.infectionReason, patient.infectedBy);
+    if (dictionaries != NULL)
+    {
+        printf("\nID: %ld \nBirth year: %d \nSex: %s \nCountry: %s \nRegion: %s \nStatus: %s \nInfection reason: %s\nInfected by: %ld \n",
+               patient.id, patient.birthYear, dictionaryString(dictionaries->sexes, patient.sexCode),
+               dictionaryString(dictionaries->countries, patient.countryCode), dictionaryString(dictionaries->regions, patient.regionCode),
+               dictionaryString(dictionaries->statuses, patient.statusCode),
+               dictionaryString(dictionaries->infectionReasons, patient.infectionReasonCode), patient.infectedBy);
+    }
+    else
+    {
+        printf("\nID: %ld \nBirth year: %d \nSex: #%d \nCountry: #%d \nRegion: #%d \nStatus: #%d \nInfection reason: #%d\nInfected by: %ld \n",
+               patient.id, patient.birthYear, patient.sexCode, patient.countryCode, patient.regionCode, patient.statusCode,
+               patient.infectionReasonCode, patient.infectedBy);
+    }
     printf("Confirmed date: ");
     datePrint(patient.confirmedDate);
     printf("\nReleased date: ");
@@ -41,11 +74,11 @@ void patientFullPrint(Patient patient)
     printf("\n=========================================");
 }
 
-void patientPrintSHOW(Patient patient, int daysWithIllness)
+void patientPrintSHOW(Patient patient, const PatientDictionaries *dictionaries, int daysWithIllness)
 {
 
     int age = patient.birthYear != -1 ? 2020 - patient.birthYear : -1;
-    printf("ID: %ld\nSex: %s\n", patient.id, patient.sex);
+    printf("ID: %ld\nSex: %s\n", patient.id, dictionaryString(dictionaries->sexes, patient.sexCode));
     if (age != -1)
     {
         printf("AGE: %d\n", age);
@@ -55,8 +88,10 @@ void patientPrintSHOW(Patient patient, int daysWithIllness)
         printf("AGE: %s\n", "unknown");
     }
 
+    const char *infectionReason = dictionaryString(dictionaries->infectionReasons, patient.infectionReasonCode);
     printf("COUNTRY/REGION: %s/%s\nINFECTION REASON: %s\nSTATE: %s\n",
-           patient.country, patient.region, strlen(patient.infectionReason) == 0 ? "unknown" : patient.infectionReason, patient.status);
+           dictionaryString(dictionaries->countries, patient.countryCode), dictionaryString(dictionaries->regions, patient.regionCode),
+           strlen(infectionReason) == 0 ? "unknown" : infectionReason, dictionaryString(dictionaries->statuses, patient.statusCode));
 
     if (daysWithIllness != -1)
     {
@@ -68,9 +103,10 @@ void patientPrintSHOW(Patient patient, int daysWithIllness)
     }
 }
 
-void patientPrintOLDEST(Patient patient)
+void patientPrintOLDEST(Patient patient, const PatientDictionaries *dictionaries)
 {
     int age = (patient.birthYear != -1 ? 2020 - patient.birthYear : -1);
     printf("ID: %ld, Sex: %s, AGE: %d, COUNTRY/REGION: %s/%s,STATE: %s\n",
-           patient.id, patient.sex, age, patient.country, patient.region, patient.status);
+           patient.id, dictionaryString(dictionaries->sexes, patient.sexCode), age, dictionaryString(dictionaries->countries, patient.countryCode),
+           dictionaryString(dictionaries->regions, patient.regionCode), dictionaryString(dictionaries->statuses, patient.statusCode));
 }
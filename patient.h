@@ -7,51 +7,84 @@
 #pragma once
 
 #include "date.h"
+#include "dictionary.h"
 
 /**
  * @brief Represents a patient.
+ * <br>The string fields are kept as codes in the dictionaries of the patients (see PatientDictionaries), so that every patient takes the same few bytes
+ * however long their strings are, and each distinct string is stored once.
  * 
  */
 typedef struct patient
 {
     long int id;
-    char sex[10];
-    int birthYear;
-    char country[40];
-    char region[40];
-    char infectionReason[100];
     long int infectedBy;
+    int birthYear;
+    int sexCode;
+    int countryCode;
+    int regionCode;
+    int infectionReasonCode;
+    int statusCode;
     Date confirmedDate;
     Date releasedDate;
     Date deceasedDate;
-    char status[10];
 } Patient;
 
+/**
+ * @brief Holds the dictionaries the string fields of a set of patients are encoded with, one per field.
+ * 
+ */
+typedef struct patientDictionaries
+{
+    PtDictionary sexes;
+    PtDictionary countries;
+    PtDictionary regions;
+    PtDictionary infectionReasons;
+    PtDictionary statuses;
+} PatientDictionaries;
+
+/**
+ * @brief Creates empty dictionaries for the string fields of patients.
+ * 
+ * @param dictionaries [out] The dictionaries. They must be released with patientDictionariesDestroy, even if their creation fails
+ * @return true if the dictionaries were successfully created or,
+ * @return false if insufficient memory for allocation
+ */
+bool patientDictionariesCreate(PatientDictionaries *dictionaries);
+
+/**
+ * @brief Releases the dictionaries of the string fields of patients. Releasing them twice is harmless.
+ * 
+ * @param dictionaries [in] The dictionaries
+ */
+void patientDictionariesDestroy(PatientDictionaries *dictionaries);
+
 /**
  * @brief Returns a newly created instance of Patient.
  * 
  * @param id [in] The patient's ID.
- * @param sex [in] The patient's sex [male/female].
+ * @param sexCode [in] The code of the patient's sex [male/female].
  * @param birthYear [in] The patient's birthyear (Numerical - YYYY).
- * @param country [in] The patient's country.
- * @param region [in] The patient's region.
- * @param infectionReason [in] The reason as to why the patient got infected.
+ * @param countryCode [in] The code of the patient's country.
+ * @param regionCode [in] The code of the patient's region.
+ * @param infectionReasonCode [in] The code of the reason as to why the patient got infected.
  * @param infectedBy [in]  Who infected the patient.
  * @param confirmedDate [in] The date that represents when the patient was confirmed to be infected.
  * @param releasedDate [in] The date that represents when the patient was released from care.
  * @param deceasedDate [in] The date that represents when the patient died.
- * @param status [in] The patient's status.
+ * @param statusCode [in] The code of the patient's status.
  * @return The newly created patient instance.
  */
-Patient patientCreate(long int id, char *sex, int birthYear, char *country, char *region, char *infectionReason,
-                      long int infectedBy, Date confirmedDate, Date releasedDate, Date deceasedDate, char *status);
+Patient patientCreate(long int id, int sexCode, int birthYear, int countryCode, int regionCode, int infectionReasonCode,
+                      long int infectedBy, Date confirmedDate, Date releasedDate, Date deceasedDate, int statusCode);
 
 /**
  * @brief Prints a textual representation of a given instance of Patient by printing all of the instance's fields.
  * 
  * @param patient [in] The instance of Patient to be printed.
+ * @param dictionaries [in] The dictionaries of the patient's string fields, or NULL to print their codes instead.
  */
-void patientFullPrint(Patient patient);
+void patientFullPrint(Patient patient, const PatientDictionaries *dictionaries);
 
 /**
  * @brief Prints a textual representation of a patient according to the fields that are meant to be shown when the "SHOW" command is selected.
@@ -66,9 +99,10 @@ void patientFullPrint(Patient patient);
  * <li>NUMBER OF DAYS WITH ILLNESS
  * </ul> 
  * @param patient [in] The instance of Patient to be printed.
+ * @param dictionaries [in] The dictionaries of the patient's string fields.
  * @param daysWithIllness [in] The patient's number of days with illness.
  */
-void patientPrintSHOW(Patient patient, int daysWithIllness);
+void patientPrintSHOW(Patient patient, const PatientDictionaries *dictionaries, int daysWithIllness);
 
 /**
  * @brief Prints a textual representation of a patient according to the fields that are meant to be shown when the "OLDEST" command is selected.
@@ -81,5 +115,6 @@ void patientPrintSHOW(Patient patient, int daysWithIllness);
  * <li>STATE
  * </ul>
  * @param patient [in] The instance of Patient to be printed.
+ * @param dictionaries [in] The dictionaries of the patient's string fields.
  */
-void patientPrintOLDEST(Patient patient);
\ No newline at end of file
+void patientPrintOLDEST(Patient patient, const PatientDictionaries *dictionaries);
\ No newline at end of file
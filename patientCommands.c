@@ -2,86 +2,354 @@
  * @file patientCommands.c
  * @author Pedro Vitória
  * @brief Provides implementations for all patient-related commands.
- * @bug [GROWTH] Subtracting -1 to obtain the previous date may cause issues if the day == 1.
  */
 
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "topfivestats.h"
+#include "spreaderstats.h"
+#include "groupBy.h"
+#include "mappedFile.h"
+#include "fieldParsers.h"
 #include "patientUtils.h"
 #include "patientCommands.h"
 
-int importPatientsFromFile(char *filename, PtList *list, int *numberOfPatientsReadFromFile, Date *mostRecentConfirmedDate)
+/**
+ * @brief Builds a patient from the fields of a line of the patients' file.
+ * 
+ * @param fields [in] The PATIENT_FIELDS fields of the line
+ * @param dictionaries [in] The dictionaries the string fields are added to
+ * @param patient [out] The patient described by the line
+ * @return true if the patient was successfully built or,
+ * @return false if insufficient memory for allocation
+ */
+static bool patientFromFields(Field fields[], PatientDictionaries *dictionaries, Patient *patient)
+{
+    patient->id = parseInteger(fields[0].start, fields[0].length, 0); //An empty id is 0, as atol gave it.
+    patient->birthYear = parseInteger(fields[2].start, fields[2].length, -1);
+    patient->infectedBy = parseInteger(fields[6].start, fields[6].length, -1);
+
+    patient->confirmedDate = parseDate(fields[7].start, fields[7].length);
+    patient->releasedDate = parseDate(fields[8].start, fields[8].length);
+    patient->deceasedDate = parseDate(fields[9].start, fields[9].length);
+
+    patient->sexCode = dictionaryIntern(dictionaries->sexes, fields[1].start, fields[1].length);
+    patient->countryCode = dictionaryIntern(dictionaries->countries, fields[3].start, fields[3].length);
+    patient->regionCode = dictionaryIntern(dictionaries->regions, fields[4].start, fields[4].length);
+    patient->infectionReasonCode = dictionaryIntern(dictionaries->infectionReasons, fields[5].start, fields[5].length);
+    patient->statusCode = dictionaryIntern(dictionaries->statuses, fields[10].start, fields[10].length);
+
+    return patient->sexCode >= 0 && patient->countryCode >= 0 && patient->regionCode >= 0 && patient->infectionReasonCode >= 0 && patient->statusCode >= 0;
+}
+
+/**
+ * @brief Represents a contiguous range of lines of the patients' file, together with the patients parsed from it.
+ * 
+ */
+typedef struct patientChunk
+{
+    const char *begin;
+    const char *end;
+    Patient *patients;
+    int size;
+    int capacity;
+    PatientDictionaries dictionaries; //The codes of the patients of the chunk, until they are translated to those of the list
+    int rejected; //The lines that don't have PATIENT_FIELDS fields
+    int scanner;  //The scanner the lines are tokenized with (see csvBestScanner)
+    bool outOfMemory;
+} PatientChunk;
+
+/**
+ * @brief Finds the beginning of the line that follows the one containing a given position.
+ * 
+ * @param position [in] A position in the file
+ * @param end [in] The end of the file
+ * @return The beginning of the next line, or <b>end</b> if there is none
+ */
+static const char *nextLineStart(const char *position, const char *end)
 {
-    FILE *f = NULL;
-    f = fopen(filename, "r");
-    if (f == NULL)
+    const char *lineEnd = memchr(position, '\n', end - position);
+    return lineEnd == NULL ? end : lineEnd + 1;
+}
+
+/**
+ * @brief Estimates the number of lines in a range of the file, from the average length of its first lines.
+ * <br>The estimate errs on the high side, so that arrays sized from it rarely have to grow.
+ * 
+ * @param begin [in] The beginning of a line
+ * @param end [in] The end of the range
+ * @return The estimated number of lines, at least 1
+ */
+static int estimateNumberOfLines(const char *begin, const char *end)
+{
+    const char *sampleEnd = begin;
+    int sampledLines = 0;
+    while (sampleEnd < end && sampledLines < LINE_ESTIMATE_SAMPLE)
     {
-        printf("File not found (%s).\n", filename);
-        return FILE_NOT_FOUND;
+        sampleEnd = nextLineStart(sampleEnd, end);
+        sampledLines++;
     }
+    if (sampledLines == 0)
+        return 1;
 
-    char nextline[1024];
-    int countPT = 0;
-    bool firstLine = true;
+    double averageLineLength = (double)(sampleEnd - begin) / sampledLines;
+    double estimate = (end - begin) / averageLineLength;
+    return (int)(estimate + estimate / 8) + 1; //12.5% margin for lines shorter than the sample
+}
 
-    *list = listCreate(3129);
-    if (list == NULL)
-        return LIST_NULL;
+/**
+ * @brief Parses every line of a chunk into the chunk's array of patients.
+ * <br>This is the entry point of the worker threads, but it is also called directly when the file is loaded sequentially.
+ * 
+ * @param arg [in] The chunk (PatientChunk *) to parse
+ * @return NULL
+ */
+static void *parsePatientChunk(void *arg)
+{
+    PatientChunk *chunk = (PatientChunk *)arg;
+    Field fields[PATIENT_FIELDS];
+    int fieldCount = 0;
 
-    while (fgets(nextline, sizeof(nextline), f))
+    const char *cursor = chunk->begin;
+    while (cursor < chunk->end)
     {
-        if (strlen(nextline) < 1)
+        //Lines are tokenized straight out of the mapping, so the line terminator is excluded instead of being overwritten.
+        cursor = tokenizeLine(chunk->scanner, cursor, chunk->end, ';', fields, PATIENT_FIELDS, &fieldCount);
+        if (fieldCount == 1 && fields[0].length == 0)
             continue;
-
-        if (firstLine)
+        if (fieldCount != PATIENT_FIELDS)
         {
-            firstLine = false;
+            chunk->rejected++;
             continue;
         }
 
-        char **tokens = split(nextline, 11, ";");
+        if (chunk->size == chunk->capacity)
+        {
+            int newCapacity = chunk->capacity * 2;
+            Patient *newArray = (Patient *)realloc(chunk->patients, newCapacity * sizeof(Patient));
+            if (newArray == NULL)
+            {
+                chunk->outOfMemory = true;
+                return NULL;
+            }
+            chunk->patients = newArray;
+            chunk->capacity = newCapacity;
+        }
+
+        if (!patientFromFields(fields, &chunk->dictionaries, &chunk->patients[chunk->size++]))
+        {
+            chunk->outOfMemory = true;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Translates the codes of a dictionary of a chunk to the codes of the same strings in a dictionary of the list, adding the strings it doesn't have yet.
+ * 
+ * @param from [in] The dictionary of the chunk
+ * @param into [in] The dictionary of the list
+ * @param translation [out] An array of at least <b>dictionarySize(from)</b> elements, filled with the code in <b>into</b> of each code of <b>from</b>
+ * @return true if the codes were successfully translated or,
+ * @return false if insufficient memory for allocation
+ */
+static bool translateCodes(PtDictionary from, PtDictionary into, int translation[])
+{
+    for (int code = 0; code < dictionarySize(from); code++)
+    {
+        const char *text = dictionaryString(from, code);
+        translation[code] = dictionaryIntern(into, text, strlen(text));
+        if (translation[code] < 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Re-encodes the patients of a chunk with the dictionaries of the list.
+ * <br>Chunks are merged in file order, so each string keeps the code of its first occurrence in the file, as if a single thread had parsed it.
+ * Only the distinct strings of the chunk are looked up, then each patient only indexes the translation tables.
+ * 
+ * @param chunk [in] The chunk
+ * @param dictionaries [in] The dictionaries of the list
+ * @return true if the patients were successfully re-encoded or,
+ * @return false if insufficient memory for allocation
+ */
+static bool mergeChunkDictionaries(PatientChunk *chunk, PatientDictionaries *dictionaries)
+{
+    int sizes[] = {dictionarySize(chunk->dictionaries.sexes), dictionarySize(chunk->dictionaries.countries), dictionarySize(chunk->dictionaries.regions),
+                   dictionarySize(chunk->dictionaries.infectionReasons), dictionarySize(chunk->dictionaries.statuses)};
+    int *sexes = (int *)malloc((sizes[0] + sizes[1] + sizes[2] + sizes[3] + sizes[4] + 1) * sizeof(int));
+    if (sexes == NULL)
+        return false;
+    int *countries = sexes + sizes[0];
+    int *regions = countries + sizes[1];
+    int *infectionReasons = regions + sizes[2];
+    int *statuses = infectionReasons + sizes[3];
+
+    bool translated = translateCodes(chunk->dictionaries.sexes, dictionaries->sexes, sexes) &&
+                      translateCodes(chunk->dictionaries.countries, dictionaries->countries, countries) &&
+                      translateCodes(chunk->dictionaries.regions, dictionaries->regions, regions) &&
+                      translateCodes(chunk->dictionaries.infectionReasons, dictionaries->infectionReasons, infectionReasons) &&
+                      translateCodes(chunk->dictionaries.statuses, dictionaries->statuses, statuses);
+    for (int i = 0; translated && i < chunk->size; i++)
+    {
+        Patient *patient = &chunk->patients[i];
+        patient->sexCode = sexes[patient->sexCode];
+        patient->countryCode = countries[patient->countryCode];
+        patient->regionCode = regions[patient->regionCode];
+        patient->infectionReasonCode = infectionReasons[patient->infectionReasonCode];
+        patient->statusCode = statuses[patient->statusCode];
+    }
+
+    free(sexes);
+    return translated;
+}
+
+int defaultNumberOfLoadingThreads(size_t fileSize)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    long threads = (long)(fileSize / MIN_BYTES_PER_LOADING_THREAD);
+
+    if (threads > cores)
+        threads = cores;
+    if (threads > MAX_LOADING_THREADS)
+        threads = MAX_LOADING_THREADS;
+
+    return threads < 1 ? 1 : (int)threads;
+}
 
-        int birthYear = isEmpty(tokens[2]) ? -1 : atoi(tokens[2]);
-        long int infectedBy = isEmpty(tokens[6]) ? -1 : atol(tokens[6]);
+int importPatientsFromFile(char *filename, PtList *list, PatientDictionaries *dictionaries, int *numberOfPatientsReadFromFile, Date *mostRecentConfirmedDate)
+{
+    return importPatientsFromFileParallel(filename, list, dictionaries, numberOfPatientsReadFromFile, mostRecentConfirmedDate, 0);
+}
+
+int importPatientsFromFileParallel(char *filename, PtList *list, PatientDictionaries *dictionaries, int *numberOfPatientsReadFromFile,
+                                   Date *mostRecentConfirmedDate, int numberOfThreads)
+{
+    MappedFile file;
+    if (!mappedFileOpen(filename, &file))
+    {
+        printf("File not found (%s).\n", filename);
+        return FILE_NOT_FOUND;
+    }
 
-        Date confirmedDate = stringToDate(tokens[7]);
-        Date releasedDate = stringToDate(tokens[8]);
-        Date deceasedDate = stringToDate(tokens[9]);
+    const char *end = file.contents + file.size;
 
-        char status[100];
-        int length = strlen(tokens[10]) - 1;
-        strncpy(status, tokens[10], length);
-        status[length - 1] = '\0';
+    //Skip the header, which is the first non-empty line.
+    const char *dataStart = file.contents;
+    while (dataStart < end && (*dataStart == '\n' || *dataStart == '\r'))
+        dataStart++;
+    dataStart = dataStart < end ? nextLineStart(dataStart, end) : end;
 
-        ListElem patient = patientCreate(atol(tokens[0]), tokens[1], birthYear,
-                                         tokens[3], tokens[4], tokens[5], infectedBy,
-                                         confirmedDate, releasedDate, deceasedDate, status);
-        free(tokens);
+    //The list is sized from the file, so that loading never grows it step by step. The previously loaded patients, if any, are released.
+    listDestroy(list);
+    *list = listCreate(estimateNumberOfLines(dataStart, end));
+    if (!patientDictionariesCreate(dictionaries) || *list == NULL)
+    {
+        mappedFileClose(&file);
+        return LIST_NULL;
+    }
 
-        int error_code = listAdd(*list, countPT, patient);
-        if (error_code == LIST_FULL || error_code == LIST_INVALID_RANK || error_code == LIST_NO_MEMORY || error_code == LIST_NULL)
+    if (numberOfThreads <= 0)
+        numberOfThreads = defaultNumberOfLoadingThreads(end - dataStart);
+    if (numberOfThreads > MAX_LOADING_THREADS)
+        numberOfThreads = MAX_LOADING_THREADS;
+
+    /* Split the data at newline boundaries: each chunk starts at the beginning of the line that follows 
+    * its nominal starting position. Chunks may end up empty if lines are long compared to the chunk size.
+    */
+    PatientChunk chunks[MAX_LOADING_THREADS];
+    int scanner = csvBestScanner();
+    size_t dataSize = end - dataStart;
+    const char *chunkBegin = dataStart;
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        const char *chunkEnd = end;
+        if (i < numberOfThreads - 1)
         {
-            printf("An error ocurred.... Please try again... \n");
-            return error_code;
+            chunkEnd = dataStart + dataSize / numberOfThreads * (i + 1);
+            chunkEnd = chunkEnd <= chunkBegin ? chunkBegin : nextLineStart(chunkEnd - 1, end);
         }
-        countPT++;
+
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunks[i].size = 0;
+        chunks[i].rejected = 0;
+        chunks[i].scanner = scanner;
+        chunks[i].capacity = estimateNumberOfLines(chunkBegin, chunkEnd);
+        chunks[i].patients = (Patient *)malloc(chunks[i].capacity * sizeof(Patient));
+        chunks[i].outOfMemory = !patientDictionariesCreate(&chunks[i].dictionaries) || chunks[i].patients == NULL;
+        chunkBegin = chunkEnd;
+    }
+
+    pthread_t workers[MAX_LOADING_THREADS];
+    bool started[MAX_LOADING_THREADS] = {false};
+    for (int i = 1; i < numberOfThreads; i++)
+    {
+        if (!chunks[i].outOfMemory)
+            started[i] = pthread_create(&workers[i], NULL, parsePatientChunk, &chunks[i]) == 0;
+    }
+    //The calling thread parses the first chunk, and any chunk whose worker failed to start.
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        if (started[i])
+            pthread_join(workers[i], NULL);
+        else if (!chunks[i].outOfMemory)
+            parsePatientChunk(&chunks[i]);
+    }
+
+    //Stitch the chunks into the list in file order, after making room for all of them at once, translating their codes to those of the list.
+    int countPT = 0;
+    int rejected = 0;
+    int error_code = FILE_OK;
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        if (chunks[i].outOfMemory)
+            error_code = LIST_NO_MEMORY;
+        countPT += chunks[i].size;
+        rejected += chunks[i].rejected;
     }
+    if (error_code == FILE_OK && listReserve(*list, countPT) != LIST_OK)
+        error_code = LIST_NO_MEMORY;
+
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        if (error_code == FILE_OK && (!mergeChunkDictionaries(&chunks[i], dictionaries) || listAppendRange(*list, chunks[i].patients, chunks[i].size) != LIST_OK))
+            error_code = LIST_NO_MEMORY;
+        free(chunks[i].patients);
+        patientDictionariesDestroy(&chunks[i].dictionaries);
+    }
+    mappedFileClose(&file);
+    listShrinkToFit(*list); //Give back whatever the estimate overshot.
+
+    if (error_code != FILE_OK)
+    {
+        printf("An error ocurred.... Please try again... \n");
+        return error_code;
+    }
+    if (rejected > 0)
+    {
+        printf("\nSkipped %d line%s of %s without %d fields.\n", rejected, rejected == 1 ? "" : "s", filename, PATIENT_FIELDS);
+    }
+
     *numberOfPatientsReadFromFile = countPT;
     *mostRecentConfirmedDate = findMostRecentConfirmedDate(*list);
-    fclose(f);
     return FILE_OK;
 }
 
-int average(PtList patientsList)
+int average(PtPatientStore patientStore, const Selection *selection)
 {
-    if (patientsList == NULL)
+    if (patientStore == NULL)
         return OPERATION_FAILURE;
 
     double averageIsolatedAge = 0, averageDeceasedAge = 0, averageReleasedAge = 0;
-    calculateAverageAgeByState(patientsList, &averageIsolatedAge, &averageDeceasedAge, &averageReleasedAge);
+    calculateAverageAgeByState(patientStore, selection, &averageIsolatedAge, &averageDeceasedAge, &averageReleasedAge);
 
     printf("\nAverage Age for deceased patients: %.0lf", round(averageDeceasedAge) > 0 ? round(averageDeceasedAge) : 0);
     printf("\nAverage Age for released patients: %.0lf", round(averageReleasedAge) > 0 ? round(averageReleasedAge) : 0);
@@ -91,63 +359,106 @@ int average(PtList patientsList)
     return OPERATION_SUCCESS;
 }
 
-int follow(PtList patientsList, long int patientID)
+int follow(PtList patientsList, PtPatientStore patientStore, long int patientID)
 {
-    if (patientsList == NULL)
+    if (patientsList == NULL || patientStore == NULL)
         return OPERATION_FAILURE;
 
-    ListElem patient;
-    bool patientExists = getPatientByID(patientsList, patientID, &patient);
-
-    if (!patientExists)
+    int row = -1;
+    if (listFind(patientsList, patientID, &row) != LIST_OK)
     {
         printf("ID:%ld : does not exist record \n", patientID);
         return OPERATION_SUCCESS;
     }
-    else if (patient.infectedBy == -1)
+
+    int *chain = (int *)malloc((patientStore->size > 0 ? patientStore->size : 1) * sizeof(int));
+    if (chain == NULL)
+        return OPERATION_FAILURE;
+
+    //The chain is walked through the infection graph, which stops before any patient would be shown twice.
+    bool cycle = false;
+    int chainLength = infectionGraphChain(&patientStore->infections, row, chain, &cycle);
+
+    for (int i = 0; i < chainLength; i++)
     {
-        int age = (patient.birthYear != -1 ? 2020 - patient.birthYear : -1);
+        const ListElem *patient;
+        listBorrow(patientsList, chain[i], &patient);
+        int age = (patient->birthYear != -1 ? 2020 - patient->birthYear : -1);
 
-        printf("ID:%ld, Sex: %s, ", patient.id, patient.sex);
+        printf("ID:%ld, Sex: %s, ", patient->id, dictionaryString(patientStore->dictionaries.sexes, patient->sexCode));
         if (age != -1)
         {
             printf("AGE: %d, ", age);
         }
         else
         {
-            printf("AGE: %s, ", "unknown");
+            printf("AGE: %s%s ", "unknown", patient->infectedBy == -1 ? "," : "");
         }
-        printf("COUNTRY/REGION: %s/%s, STATE: %s\ncontaminated by Unknown\n", patient.country, patient.region, patient.status);
-        return OPERATION_SUCCESS;
-    }
-    else
-    {
-        int age = (patient.birthYear != -1 ? 2020 - patient.birthYear : -1);
+        printf("COUNTRY/REGION: %s/%s, STATE: %s\n", dictionaryString(patientStore->dictionaries.countries, patient->countryCode),
+               dictionaryString(patientStore->dictionaries.regions, patient->regionCode), dictionaryString(patientStore->dictionaries.statuses, patient->statusCode));
 
-        printf("ID:%ld, Sex: %s, ", patient.id, patient.sex);
-        if (age != -1)
+        if (patient->infectedBy == -1)
         {
-            printf("AGE: %d, ", age);
+            printf("contaminated by Unknown\n");
+        }
+        else if (i == chainLength - 1 && cycle)
+        {
+            printf("contaminated by Patient: ID:%ld : already shown above, the contamination sequence loops\n", patient->infectedBy);
+        }
+        else if (i == chainLength - 1)
+        {
+            printf("contaminated by Patient: ID:%ld : does not exist record \n", patient->infectedBy);
         }
         else
         {
-            printf("AGE: %s ", "unknown");
+            printf("contaminated by Patient: ");
         }
+    }
+
+    free(chain);
+    return OPERATION_SUCCESS;
+}
+
+int infected(PtList patientsList, PtPatientStore patientStore, long int patientID)
+{
+    if (patientsList == NULL || patientStore == NULL)
+        return OPERATION_FAILURE;
+
+    int row = -1;
+    if (listFind(patientsList, patientID, &row) != LIST_OK)
+    {
+        printf("ID:%ld : does not exist record \n", patientID);
+        return OPERATION_SUCCESS;
+    }
+
+    int *descendants = (int *)malloc((patientStore->size > 0 ? patientStore->size : 1) * sizeof(int));
+    if (descendants == NULL)
+        return OPERATION_FAILURE;
 
-        printf("COUNTRY/REGION: %s/%s, STATE: %s\ncontaminated by Patient: ", patient.country, patient.region, patient.status);
-        follow(patientsList, patient.infectedBy);
+    InfectionGraph *graph = &patientStore->infections;
+    int depth = infectionGraphDepth(graph, row);
+    int count = infectionGraphDescendants(graph, row, descendants);
+
+    printf("ID:%ld, infections since the first known patient of the contamination sequence: %d\n", patientID, depth);
+    printf("Patients infected, directly or not: %d\n", count);
+    for (int i = 0; i < count; i++)
+    {
+        int descendant = descendants[i];
+        printf("ID:%ld, contaminated by Patient: ID:%ld\n", patientStore->ids[descendant], patientStore->ids[graph->parents[descendant]]);
     }
+
+    free(descendants);
+    return OPERATION_SUCCESS;
 }
 
-int sex(PtList patientsList)
+int sex(PtPatientStore patientStore, const Selection *selection)
 {
-    if (patientsList == NULL)
+    if (patientStore == NULL)
         return OPERATION_FAILURE;
 
     double malePercentage = 0, femalePercentage = 0, unknownPercentage = 0;
-    int numberOfPatients = 0;
-    listSize(patientsList, &numberOfPatients);
-    calculatePercentageOfInfectedPatientsBySex(patientsList, &malePercentage, &femalePercentage, &unknownPercentage);
+    int numberOfPatients = selection != NULL ? selection->count : patientStore->size;
+    calculatePercentageOfInfectedPatientsBySex(patientStore, selection, &malePercentage, &femalePercentage, &unknownPercentage);
 
     printf("\nPercentage of Females: %.0lf%% ", round(femalePercentage));
     printf("\nPercentage of Males: %.0lf%% ", round(malePercentage));
@@ -158,9 +469,9 @@ int sex(PtList patientsList)
     return OPERATION_SUCCESS;
 }
 
-int show(PtList patientsList, long int idOfPatientToShow, Date mostRecentConfirmedDate)
+int show(PtList patientsList, PtPatientStore patientStore, long int idOfPatientToShow, Date mostRecentConfirmedDate)
 {
-    if (patientsList == NULL)
+    if (patientsList == NULL || patientStore == NULL)
         return OPERATION_FAILURE;
 
     Patient soughtPatient;
@@ -173,7 +484,7 @@ int show(PtList patientsList, long int idOfPatientToShow, Date mostRecentConfirm
         {
             daysWithIllness = getDifferenceBetweenDates(soughtPatient.confirmedDate, soughtPatient.releasedDate);
         }
-        else if (strcmp(soughtPatient.status, "isolated") == 0)
+        else if (soughtPatient.statusCode == patientStore->isolatedCode)
         {
             daysWithIllness = getDifferenceBetweenDates(soughtPatient.confirmedDate, mostRecentConfirmedDate);
         }
@@ -185,7 +496,7 @@ int show(PtList patientsList, long int idOfPatientToShow, Date mostRecentConfirm
         {
             daysWithIllness = -1;
         }
-        patientPrintSHOW(soughtPatient, daysWithIllness);
+        patientPrintSHOW(soughtPatient, &patientStore->dictionaries, daysWithIllness);
     }
     else
     {
@@ -195,113 +506,125 @@ int show(PtList patientsList, long int idOfPatientToShow, Date mostRecentConfirm
     return OPERATION_SUCCESS;
 }
 
-int top5(PtList patientsList)
+int top5(PtList patientsList, PtPatientStore patientStore, const Selection *selection)
 {
-    if (patientsList == NULL)
+    if (patientsList == NULL || patientStore == NULL)
         return OPERATION_FAILURE;
 
-    int sizeAllPatientsList = 0;
-    listSize(patientsList, &sizeAllPatientsList);
+    int patientsToDisplay = 5; //Change this value to show more patients.
+    TopFiveStats *topStats = (TopFiveStats *)malloc(patientsToDisplay * sizeof(TopFiveStats));
+    if (topStats == NULL)
+        return OPERATION_FAILURE;
 
-    int sizeReleasedList = 0;
-    int releasedListInitialCapacity = calculateReleasedByAgeRange(patientsList, 0, 152); //Allot enough capacity to fit every released patient existent in the list
+    int numberOfTopPatients = selectTopReleased(patientStore, selection, patientsToDisplay, topStats);
 
-    PtList patientsReleasedList = listCreate(releasedListInitialCapacity);
-    if (patientsReleasedList == NULL)
-        return OPERATION_FAILURE;
+    //The stats keep the row of each patient, which is also their rank in the list, from where the patient is fetched to be shown.
+    printf("\n");
+    const ListElem *releasedPatient;
+    for (int i = 0; i < numberOfTopPatients; i++)
+    {
+        listBorrow(patientsList, topStats[i].rank, &releasedPatient);
+        patientPrintSHOW(*releasedPatient, &patientStore->dictionaries, topStats[i].daysWithIllness);
+        printf("\n");
+    }
+
+    free(topStats);
+    return OPERATION_SUCCESS;
+}
 
-    filterListByReleased(patientsList, sizeAllPatientsList, &patientsReleasedList, &sizeReleasedList);
+int spreaders(PtList patientsList, PtPatientStore patientStore, int patientsToDisplay)
+{
+    if (patientsList == NULL || patientStore == NULL)
+        return OPERATION_FAILURE;
 
-    TopFiveStats topFiveStatsArray[sizeReleasedList]; //To store the elements so the sorting can be more easily done while at the same time, retaining access to the data type TopFiveStats.
-    fillTopFiveArray(patientsReleasedList, topFiveStatsArray, sizeReleasedList);
+    SpreaderStats *topStats = (SpreaderStats *)malloc((patientsToDisplay > 0 ? patientsToDisplay : 1) * sizeof(SpreaderStats));
+    if (topStats == NULL)
+        return OPERATION_FAILURE;
 
-    sortTopFiveByDaysToRecover(topFiveStatsArray, sizeReleasedList);
-    sortTopFiveByAgeTie(topFiveStatsArray, sizeReleasedList);
+    int numberOfTopPatients = selectTopSpreaders(patientStore, patientsToDisplay, topStats);
+    if (numberOfTopPatients == -1)
+    {
+        free(topStats);
+        return OPERATION_FAILURE;
+    }
 
-    /*
-    *The patients are in the filtered list, their stats are in the array. By combining the index of the array of stats with the underlying logic of getPatientByID, we get the final output.
-    *getPatientByID will use the ID stored in the stats array to fetch the patient to be shown, which is then stored in releasedPatient by reference.
-    *Afterwards, we show the patient.
-    */
-    printf("\n");
-    ListElem releasedPatient;
-    int patientsToDisplay = 5; //Change this value to show more patients.
-    for (int i = 0; i < patientsToDisplay; i++)
+    if (numberOfTopPatients == 0)
     {
-        if (getPatientByID(patientsReleasedList, topFiveStatsArray[i].patientID, &releasedPatient))
-        {
-            patientPrintSHOW(releasedPatient, topFiveStatsArray[i].daysWithIllness);
-            printf("\n");
-        }
+        printf("\nNo patient is known to have infected another patient.\n");
+    }
+    for (int i = 0; i < numberOfTopPatients; i++)
+    {
+        spreaderStatsPrint(topStats[i]);
     }
-    //Dealloc the list we used to filter.
-    listDestroy(&patientsReleasedList);
+
+    free(topStats);
     return OPERATION_SUCCESS;
 }
 
-int oldest(PtList patientsList)
+int oldest(PtList patientsList, PtPatientStore patientStore)
 {
-    if (patientsList == NULL)
+    if (patientsList == NULL || patientStore == NULL)
         return OPERATION_FAILURE;
 
-    int sizeOfList = 0;
-    listSize(patientsList, &sizeOfList);
-    ListElem patient;
+    int sizeOfList = patientStore->size;
+    const ListElem *patient;
 
     int earliestMaleYear = 0, earliestFemaleYear = 0;
 
-    calculateEarliestBirthYearBySex(patientsList, &earliestMaleYear, &earliestFemaleYear);
+    calculateEarliestBirthYearBySex(patientStore, &earliestMaleYear, &earliestFemaleYear);
 
+    //Only the matching rows are fetched from the list, to be printed.
     printf("\nFEMALE:\n");
     for (int i = 0; i < sizeOfList; i++)
     {
-        listGet(patientsList, i, &patient);
-
-        if (strcmp(patient.sex, "female") == 0)
+        if (patientStore->birthYears[i] == earliestFemaleYear && patientStore->sexCodes[i] == patientStore->femaleCode)
         {
-            if (patient.birthYear == earliestFemaleYear)
-            {
-                patientPrintOLDEST(patient);
-            }
+            listBorrow(patientsList, i, &patient);
+            patientPrintOLDEST(*patient, &patientStore->dictionaries);
         }
     }
 
     printf("\nMALE:\n");
     for (int i = 0; i < sizeOfList; i++)
     {
-        listGet(patientsList, i, &patient);
-
-        if (strcmp(patient.sex, "male") == 0)
+        if (patientStore->birthYears[i] == earliestMaleYear && patientStore->sexCodes[i] == patientStore->maleCode)
         {
-            if (patient.birthYear == earliestMaleYear)
-            {
-                patientPrintOLDEST(patient);
-            }
+            listBorrow(patientsList, i, &patient);
+            patientPrintOLDEST(*patient, &patientStore->dictionaries);
         }
     }
     return OPERATION_SUCCESS;
 }
 
-int growth(PtList patientsList, Date date)
+/**
+ * @brief Retrieves the counts shown by the <b>GROWTH</b> command for a date and the date before it.
+ * 
+ * @param patientStore [in] A columnar store of patients
+ * @param date [in] The current date
+ * @param previousDeaths [out] The deaths on the previous date
+ * @param currentDeaths [out] The deaths on the current date, with the deaths of the previous date added as well
+ * @param previousIsolated [out] The patients confirmed on the previous date
+ * @param currentIsolated [out] The patients confirmed on the current date
+ * @return true if there are records of both kinds for both dates or,
+ * @return false otherwise
+ */
+static bool growthCounts(PtPatientStore patientStore, Date date, int *previousDeaths, int *currentDeaths, int *previousIsolated, int *currentIsolated)
 {
-    if (patientsList == NULL)
-        return OPERATION_FAILURE;
+    Date previousDate = dateFromEpochDay(date.epochDay - 1);
+    deathsPreviousToCurrentDay(patientStore, date, previousDate, previousDeaths, currentDeaths);
+    isolatedPreviousToCurrentDay(patientStore, date, previousDate, previousIsolated, currentIsolated);
 
-    int prevDateDeaths = 0;
-    int currentDeaths = 0;
-    Date previousDate = dateCreate(date.day - 1, date.month, date.year);
-    deathsPreviousToCurrentDay(patientsList, date, previousDate, &prevDateDeaths, &currentDeaths);
-    if (prevDateDeaths < 1 || currentDeaths < 1)
-    {
-        printf("\nThere is no record for date <");
-        datePrint(date);
-        printf(">");
+    return *previousDeaths >= 1 && *currentDeaths >= 1 && *previousIsolated >= 1 && *currentIsolated >= 1;
+}
+
+int growth(PtPatientStore patientStore, Date date)
+{
+    if (patientStore == NULL)
         return OPERATION_FAILURE;
-    }
-    int prevDateIsolated = 0;
-    int currentIsolated = 0;
-    isolatedPreviousToCurrentDay(patientsList, date, previousDate, &prevDateIsolated, &currentIsolated);
-    if (prevDateIsolated < 1 || currentIsolated < 1)
+
+    int prevDateDeaths = 0, currentDeaths = 0;
+    int prevDateIsolated = 0, currentIsolated = 0;
+    if (!growthCounts(patientStore, date, &prevDateDeaths, &currentDeaths, &prevDateIsolated, &currentIsolated))
     {
         printf("\nThere is no record for date <");
         datePrint(date);
@@ -310,7 +633,7 @@ int growth(PtList patientsList, Date date)
     }
 
     printf("\nDate:<");
-    datePrint(previousDate);
+    datePrint(dateFromEpochDay(date.epochDay - 1));
     printf(">\nNumber of dead: %d", prevDateDeaths);
     printf("\nNumber of isolated: %d", prevDateIsolated);
     printf("\n\n");
@@ -330,26 +653,111 @@ int growth(PtList patientsList, Date date)
     return OPERATION_SUCCESS;
 }
 
-int matrix(PtList patientsList)
+int growthOverRange(PtPatientStore patientStore, Date firstDate, Date lastDate)
+{
+    if (patientStore == NULL || firstDate.epochDay <= 0 || lastDate.epochDay < firstDate.epochDay)
+        return OPERATION_FAILURE;
+
+    //Every day takes constant time, through the daily series of the store.
+    printf("\n%-12s|  %s |  %s |  %s |  %s |", "Date", "Dead", "Isol", "New infected", "New dead");
+    printf("\n");
+    for (int day = firstDate.epochDay; day <= lastDate.epochDay; day++)
+    {
+        Date date = dateFromEpochDay(day);
+        int prevDateDeaths = 0, currentDeaths = 0;
+        int prevDateIsolated = 0, currentIsolated = 0;
+        bool hasRecord = growthCounts(patientStore, date, &prevDateDeaths, &currentDeaths, &prevDateIsolated, &currentIsolated);
+
+        int dayDeaths = currentDeaths - prevDateDeaths; //growthCounts adds the previous day's deaths, as GROWTH shows them
+
+        datePrint(date);
+        printf("  | %5d | %5d |", dayDeaths, currentIsolated);
+        if (hasRecord)
+        {
+            double rateDeaths = ((double)(dayDeaths - prevDateDeaths) / (double)prevDateDeaths) * 100;
+            double rateInfected = ((double)(currentIsolated - prevDateIsolated) / (double)prevDateIsolated) * 100;
+            printf(" %12.0lf%% | %8.0lf%% |", rateInfected > 0 ? rateInfected : 0, rateDeaths > 0 ? rateDeaths : 0);
+        }
+        else
+        {
+            printf(" %13s | %9s |", "-", "-");
+        }
+        printf("\n");
+    }
+
+    return OPERATION_SUCCESS;
+}
+
+int groupBy(PtPatientStore patientStore, char *dimensionNames, const Selection *selection)
+{
+    if (patientStore == NULL)
+        return OPERATION_FAILURE;
+
+    int dimensions[GROUP_BY_MAX_DIMENSIONS];
+    int dimensionCount = 0;
+    for (char *name = strtok(dimensionNames, " ,"); name != NULL; name = strtok(NULL, " ,"))
+    {
+        if (dimensionCount == GROUP_BY_MAX_DIMENSIONS)
+        {
+            printf("\nPlease insert from 1 to %d dimensions.\n", GROUP_BY_MAX_DIMENSIONS);
+            return OPERATION_SUCCESS;
+        }
+        dimensions[dimensionCount] = groupDimensionFromName(name);
+        if (dimensions[dimensionCount] == -1)
+        {
+            printf("\n%s : Dimension not found.\n", name);
+            return OPERATION_SUCCESS;
+        }
+        dimensionCount++;
+    }
+    if (dimensionCount == 0)
+    {
+        printf("\nPlease insert from 1 to %d dimensions.\n", GROUP_BY_MAX_DIMENSIONS);
+        return OPERATION_SUCCESS;
+    }
+
+    int groupCount = 0;
+    Group *groups = groupByCount(patientStore, selection, dimensions, dimensionCount, &groupCount);
+    if (groups == NULL)
+        return OPERATION_FAILURE;
+
+    printf("\n");
+    for (int d = 0; d < dimensionCount; d++)
+    {
+        printf("%-20s| ", groupDimensionName(dimensions[d]));
+    }
+    printf("%s\n", "Patients");
+
+    char buffer[16];
+    for (int g = 0; g < groupCount; g++)
+    {
+        for (int d = 0; d < dimensionCount; d++)
+        {
+            printf("%-20s| ", groupValueText(patientStore, dimensions[d], groups[g].values[d], buffer, sizeof(buffer)));
+        }
+        printf("%d\n", groups[g].count);
+    }
+    printf("\n%d groups\n", groupCount);
+
+    free(groups);
+    return OPERATION_SUCCESS;
+}
+
+int matrix(PtPatientStore patientStore, const Selection *selection)
 {
-    if (patientsList == NULL)
+    if (patientStore == NULL)
         return OPERATION_FAILURE;
 
-    int mat[6][3] = {
-        {calculateIsolatedByAgeRange(patientsList, 0, 15), calculateDeceasedByAgeRange(patientsList, 0, 15), calculateReleasedByAgeRange(patientsList, 0, 15)},
-        {calculateIsolatedByAgeRange(patientsList, 16, 30), calculateDeceasedByAgeRange(patientsList, 16, 30), calculateReleasedByAgeRange(patientsList, 16, 30)},
-        {calculateIsolatedByAgeRange(patientsList, 31, 45), calculateDeceasedByAgeRange(patientsList, 31, 45), calculateReleasedByAgeRange(patientsList, 31, 45)},
-        {calculateIsolatedByAgeRange(patientsList, 46, 60), calculateDeceasedByAgeRange(patientsList, 46, 60), calculateReleasedByAgeRange(patientsList, 46, 60)},
-        {calculateIsolatedByAgeRange(patientsList, 61, 75), calculateDeceasedByAgeRange(patientsList, 61, 75), calculateReleasedByAgeRange(patientsList, 61, 75)},
-        {calculateIsolatedByAgeRange(patientsList, 76, 152), calculateDeceasedByAgeRange(patientsList, 76, 152), calculateReleasedByAgeRange(patientsList, 76, 152)},
-    };
+    PatientStats stats;
+    patientStoreSelectionStats(patientStore, selection, &stats);
+    const int(*mat)[STATUS_COLUMNS] = stats.ageBandByStatus;
 
     printf("\n\t|  %s |  %s |  %s |", "Isol", "Dcsd", "Rlsd");
     printf("\n");
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < AGE_BANDS; i++)
     {
         printf("%s ", i == 0 ? "[0-15]\t|" : i == 1 ? "[16-30]\t|" : i == 2 ? "[31-45]\t|" : i == 3 ? "[46-30]\t|" : i == 4 ? "[61-75]\t|" : "[76...[\t|");
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < STATUS_COLUMNS; j++)
         {
             printf("%5d\t|", mat[i][j]);
         }
@@ -358,3 +766,15 @@ int matrix(PtList patientsList)
 
     return OPERATION_SUCCESS;
 }
+
+void showStoreMemory(PtPatientStore patientStore)
+{
+    if (patientStore == NULL)
+        return;
+
+    printf("The patient store takes %.1f KB of memory (%.1f KB reserved)",
+           patientStore->arena.allocated / 1024.0, patientStore->arena.reserved / 1024.0);
+    if (patientStore->mapping.size > 0)
+        printf(", and uses %.1f KB of the snapshot in place", patientStore->mapping.size / 1024.0);
+    printf("\n");
+}
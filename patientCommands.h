@@ -11,13 +11,30 @@
 #define OPERATION_SUCCESS 10
 #define OPERATION_FAILURE 11
 
+/** The number of fields in each line of the patients' file. */
+#define PATIENT_FIELDS 11
+
+/** The maximum number of threads used to parse the patients' file. */
+#define MAX_LOADING_THREADS 64
+
+/** The minimum amount of data, in bytes, that justifies parsing the patients' file on an additional thread. */
+#define MIN_BYTES_PER_LOADING_THREAD (1 << 20)
+
+/** The number of lines sampled to estimate the number of patients in the patients' file, which sizes the list before loading. */
+#define LINE_ESTIMATE_SAMPLE 64
+
 #include "list.h"
 #include "patientUtils.h"
 
 /**
  * @brief Imports the contents of a file containing information about a number of patients and stores it on a List
+ * <br>The file is memory-mapped and each line is tokenized in place, without any per-line allocation.
+ * Large files are parsed on several threads (see importPatientsFromFileParallel).
+ * <br>Lines that don't have PATIENT_FIELDS fields are skipped, and how many were skipped is shown.
  * @param filename [in] The name of the file
  * @param list [in] The address of an instance of List which will store the imported information. Henceforth, this will be the list of patients
+ * @param dictionaries [out] The dictionaries the string fields of the patients are encoded with. Unless the file is not found, they are created
+ * and must be released, usually by handing them to patientStoreCreate
  * @param numberOfPatientsReadFromFile [out] The number of patiends read from the imported file
  * @param mostRecentConfirmedDate [out] The most recent confirmed date of COVID-19 contamination
  * @return FILE_OK if file is successfully imported
@@ -27,7 +44,37 @@
  * @return LIST_INVALID_RANK If the rank for an element's insertion is not valid
  * @return LIST_NO_MEMORY if insufficient memory for allocation
  */
-int importPatientsFromFile(char *filename, PtList *list, int *numberOfPatientsReadFromFile, Date *mostRecentConfirmedDate);
+int importPatientsFromFile(char *filename, PtList *list, PatientDictionaries *dictionaries, int *numberOfPatientsReadFromFile, Date *mostRecentConfirmedDate);
+
+/**
+ * @brief Imports the contents of a file containing information about a number of patients, parsing it on several threads.
+ * <br>The file is split at line boundaries into one chunk per thread. The patients parsed from each chunk are then added to the list in file order,
+ * so the resulting list is identical to the one produced by a sequential import.
+ * 
+ * @param filename [in] The name of the file
+ * @param list [in] The address of an instance of List which will store the imported information
+ * @param dictionaries [out] The dictionaries the string fields of the patients are encoded with (see importPatientsFromFile).
+ * Each thread encodes its chunk with dictionaries of its own, which are merged in file order, so the codes are also those of a sequential import
+ * @param numberOfPatientsReadFromFile [out] The number of patiends read from the imported file
+ * @param mostRecentConfirmedDate [out] The most recent confirmed date of COVID-19 contamination
+ * @param numberOfThreads [in] The number of threads to use (at most MAX_LOADING_THREADS), or 0 to pick it from the file size and the number of available cores
+ * @return FILE_OK if file is successfully imported
+ * @return FILE_NOT_FOUND if the requested file to be opened is not found
+ * @return LIST_NULL If the list is null
+ * @return LIST_FULL If the list has no more capacity available
+ * @return LIST_INVALID_RANK If the rank for an element's insertion is not valid
+ * @return LIST_NO_MEMORY if insufficient memory for allocation
+ */
+int importPatientsFromFileParallel(char *filename, PtList *list, PatientDictionaries *dictionaries, int *numberOfPatientsReadFromFile,
+                                   Date *mostRecentConfirmedDate, int numberOfThreads);
+
+/**
+ * @brief Determines how many threads are worth using to parse a patients' file of a given size.
+ * 
+ * @param fileSize [in] The size of the file in bytes
+ * @return One thread per MIN_BYTES_PER_LOADING_THREAD bytes, limited by the number of available cores and by MAX_LOADING_THREADS
+ */
+int defaultNumberOfLoadingThreads(size_t fileSize);
 
 /**
  * @brief Shows the following averages
@@ -36,21 +83,24 @@ int importPatientsFromFile(char *filename, PtList *list, int *numberOfPatientsRe
  * <li> Average age of released patients
  * <li> Average age of deceased patients
  * </ul>
- * @param patientsList [in] A list of patients
+ * @param patientStore [in] A columnar store of patients
+ * @param selection [in] The patients to include (see predicateSelect), or NULL for all
  * @return OPERATION_SUCCESS If the averages are successfully calculated and shown
- * @return OPERATION_FAILURE If the list is NULL
+ * @return OPERATION_FAILURE If the store is NULL
  */
-int average(PtList patientsList);
+int average(PtPatientStore patientStore, const Selection *selection);
 
 /**
  * @brief Tracks and shows the contamination sequence starting with a given patient
+ * <br>The sequence is walked iteratively through the infection graph of the store, and stops if it loops back to a patient already shown.
  * 
  * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients
  * @param patientID [in] The ID of the contamination sequence's initial patient
  * @return OPERATION_SUCCESS If the function is able to begin tracking the contamination sequence
- * @return OPERATION_FAILURE If the list is NULL
+ * @return OPERATION_FAILURE If the list or the store are NULL, or if insufficient memory for allocation
  */
-int follow(PtList patientsList, long int patientID);
+int follow(PtList patientsList, PtPatientStore patientStore, long int patientID);
 
 /**
  * @brief Shows the percentage of:
@@ -59,56 +109,123 @@ int follow(PtList patientsList, long int patientID);
  * <li> Female patients
  * <li> Patients for whom the sex is unknown
  * </ul>
- * @param patientsList [in] A list of patients. 
+ * @param patientStore [in] A columnar store of patients
+ * @param selection [in] The patients to include (see predicateSelect), or NULL for all
  * @return OPERATION_SUCCESS If the sex percentages are successfully calculated and shown
- * @return OPERATION_FAILURE If the list is NULL
+ * @return OPERATION_FAILURE If the store is NULL
  */
-int sex(PtList patientsList);
+int sex(PtPatientStore patientStore, const Selection *selection);
 
 /**
  * @brief Shows a patient's data according to their ID
  * 
  * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients, whose dictionaries hold their string fields
  * @param idOfPatientToShow [in] The patients ID
  * @param mostRecentConfirmedDate [in] The most recent confirmed date of infection
  * @return OPERATION_SUCCESS If the patient exists and is shown
- * @return OPERATION_FAILURE If the list is NULL or if the supplied ID does not exist in the list of patients
+ * @return OPERATION_FAILURE If the list or the store are NULL or if the supplied ID does not exist in the list of patients
  */
-int show(PtList patientsList, long int idOfPatientToShow, Date mostRecentConfirmedDate);
+int show(PtList patientsList, PtPatientStore patientStore, long int idOfPatientToShow, Date mostRecentConfirmedDate);
 
 /**
  * @brief Shows, in descending order, the 5 patients that took the longest to recover 
  * 
  * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients
+ * @param selection [in] The patients to include (see predicateSelect), or NULL for all
  * @return OPERATION_SUCCESS If the top 5 patients are successfully determined and shown
- * @return OPERATION_FAILURE If either the patient's list or the filtered list are NULL
+ * @return OPERATION_FAILURE If the patient's list, the store or the filtered list are NULL
+ */
+int top5(PtList patientsList, PtPatientStore patientStore, const Selection *selection);
+
+/**
+ * @brief Shows how far a patient is from the start of their contamination sequence, and every patient they infected, directly or not
+ * <br>The patients infected are shown in breadth-first order, each with the patient who infected them, and each of them once,
+ * even if the contamination sequence loops back to the patient. Takes time proportional to the number of patients shown.
+ * 
+ * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients
+ * @param patientID [in] The ID of the patient
+ * @return OPERATION_SUCCESS If the function is able to find the patients infected
+ * @return OPERATION_FAILURE If the list or the store are NULL, or if insufficient memory for allocation
+ */
+int infected(PtList patientsList, PtPatientStore patientStore, long int patientID);
+
+/**
+ * @brief Shows, in descending order, the patients that infected the most others, directly or through the patients they infected
+ * <br>Every patient's descendants are counted in a single pass over the infection graph of the store, so the command takes linear time.
+ * 
+ * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients
+ * @param patientsToDisplay [in] The number of patients to show
+ * @return OPERATION_SUCCESS If the patients are successfully determined and shown
+ * @return OPERATION_FAILURE If the list or the store are NULL, or if insufficient memory for allocation
  */
-int top5(PtList patientsList);
+int spreaders(PtList patientsList, PtPatientStore patientStore, int patientsToDisplay);
 
 /**
  * @brief Shows the oldest patients in a list of patients. <br>The patients are divided and shown by sex
  * 
  * @param patientsList [in] A list of patients
+ * @param patientStore [in] The columnar store of the same patients
  * @return OPERATION_SUCCESS If the oldest patients are successfully determined and shown
- * @return OPERATION_FAILURE If the list is NULL
+ * @return OPERATION_FAILURE If either the list or the store are NULL
  */
-int oldest(PtList patientsList);
+int oldest(PtList patientsList, PtPatientStore patientStore);
 
 /**
  * @brief Shows the growth rate of deaths and contaminations with regards to the previous date
  * 
- * @param patientsList [in] A list of patients
- * @param date [in] The current date. <br>The previous date to the current date is calculated implictly
+ * @param patientStore [in] A columnar store of patients
+ * @param date [in] The current date. <br>The previous date to the current date is calculated implictly, across months and years
  * @return OPERATION_SUCCESS If the growth rate is successfully determined and shown
- * @return OPERATION_FAILURE If the list is NULL or there are no records for the specified date
+ * @return OPERATION_FAILURE If the store is NULL or there are no records for the specified date
  */
-int growth(PtList patientsList, Date date);
+int growth(PtPatientStore patientStore, Date date);
+
+/**
+ * @brief Shows, for each date of a range, the deaths and contaminations of that date and their growth rates from the previous date, one date per line.
+ * <br>Unlike <b>GROWTH</b>, which adds the previous date's deaths to the current date's, every count is the date's own.
+ * <br>Dates without records of both deaths and contaminations on them and on the previous date show no rates.
+ * Each date takes constant time, since the counts are read from the daily series of the store.
+ * 
+ * @param patientStore [in] A columnar store of patients
+ * @param firstDate [in] The first date of the range
+ * @param lastDate [in] The last date of the range
+ * @return OPERATION_SUCCESS If the growth rates are successfully shown
+ * @return OPERATION_FAILURE If the store is NULL or the range is not valid
+ */
+int growthOverRange(PtPatientStore patientStore, Date firstDate, Date lastDate);
+
+/**
+ * @brief Shows the number of patients of each combination of values of 1 to 3 dimensions (a cross-tab), one combination per line.
+ * <br>The dimensions are: sex, status, region, country, infection_case, age_band and confirmed_month (see groupByCount).
+ * The patients are counted in a single scan, by hash aggregation over the codes of the store.
+ * 
+ * @param patientStore [in] A columnar store of patients
+ * @param dimensionNames [in] The names of the dimensions, separated by spaces or commas. The string is modified
+ * @param selection [in] The patients to include (see predicateSelect), or NULL for all
+ * @return OPERATION_SUCCESS If the counts are successfully shown, or the dimensions are not valid, in which case the reason is shown
+ * @return OPERATION_FAILURE If the store is NULL or if insufficient memory for allocation
+ */
+int groupBy(PtPatientStore patientStore, char *dimensionNames, const Selection *selection);
 
 /**
  * @brief Creates and prints a 6x3 matrix containing information about isolated, deceased and released patients in several different age groups
  * 
- * @param patientsList [in] A list of patients
+ * @param patientStore [in] A columnar store of patients
+ * @param selection [in] The patients to include (see predicateSelect), or NULL for all
  * @return OPERATION_SUCCESS If the matrix is successfully assembled and shown
- * @return OPERATION_FAILURE If the list is NULL
+ * @return OPERATION_FAILURE If the store is NULL
+ */
+int matrix(PtPatientStore patientStore, const Selection *selection);
+
+/**
+ * @brief Shows the memory taken by the columns, infection graph and daily series of a patient store, and the memory its arena reserved for them.
+ * <br>For a store opened from a snapshot, the size of the mapped snapshot, whose columns the store uses in place, is shown as well.
+ * Nothing is shown if the store is NULL.
+ * 
+ * @param patientStore [in] A columnar store of patients
  */
-int matrix(PtList patientsList);
+void showStoreMemory(PtPatientStore patientStore);
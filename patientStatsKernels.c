@@ -0,0 +1,299 @@
+/**
+ * @file patientStatsKernels.c
+ * @author Pedro Vitória
+ * @brief Provides the vectorized and scalar implementations of the kernel that accumulates the statistics of a patient store.
+ */
+
+#include "patientStatsKernels.h"
+#include <limits.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+
+/** The oldest age of each age band, as shown by the MATRIX command. Each band starts right after the previous one, and the first at 0. */
+static const int bandEnds[AGE_BANDS] = {15, 30, 45, 60, 75, 152};
+
+int patientAgeBand(int age)
+{
+    if (age < 0)
+        return -1;
+    for (int band = 0; band < AGE_BANDS; band++)
+    {
+        if (age <= bandEnds[band])
+            return band;
+    }
+    return -1;
+}
+
+/**
+ * @brief Finds the column of a status code in the statistics by status.
+ *
+ * @param store [in] A columnar store of patients
+ * @param statusCode [in] The code of the status of a patient
+ * @return The column of the status, or
+ * @return -1 if the status isn't isolated, deceased nor released
+ */
+static int statusColumn(const PatientStore *store, int statusCode)
+{
+    if (statusCode == store->isolatedCode)
+        return STATUS_ISOLATED;
+    if (statusCode == store->deceasedCode)
+        return STATUS_DECEASED;
+    if (statusCode == store->releasedCode)
+        return STATUS_RELEASED;
+    return -1;
+}
+
+/**
+ * @brief Accumulates the statistics of a range of rows one row at a time.
+ *
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The rows to include, or NULL for all
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param stats [in] The statistics to accumulate into
+ */
+static void accumulateScalar(const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats)
+{
+    for (int i = begin; i < end; i++)
+    {
+        if (!selectionContains(selection, i))
+            continue;
+
+        int sexCode = store->sexCodes[i];
+        int birthYear = store->birthYears[i];
+        int column = statusColumn(store, store->statusCodes[i]);
+
+        if (sexCode == store->maleCode)
+        {
+            stats->maleCount++;
+            if (birthYear != -1 && birthYear < stats->earliestMaleYear)
+                stats->earliestMaleYear = birthYear;
+        }
+        else if (sexCode == store->femaleCode)
+        {
+            stats->femaleCount++;
+            if (birthYear != -1 && birthYear < stats->earliestFemaleYear)
+                stats->earliestFemaleYear = birthYear;
+        }
+        else
+        {
+            stats->unknownSexCount++;
+        }
+
+        if (column == -1 || birthYear == -1)
+            continue;
+
+        int age = 2020 - birthYear;
+        stats->agedCountByStatus[column]++;
+        stats->ageSumByStatus[column] += age;
+
+        int band = patientAgeBand(age);
+        if (band != -1)
+            stats->ageBandByStatus[band][column]++;
+    }
+}
+
+#ifdef KERNELS_X86
+/**
+ * @brief Adds up the 8 lanes of a vector of 32-bit integers.
+ *
+ * @param vector [in] The vector
+ * @return The sum of the lanes
+ */
+__attribute__((target("avx2"))) static int sumLanes(__m256i vector)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(vector), _mm256_extracti128_si256(vector, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+/**
+ * @brief Finds the smallest of the 8 lanes of a vector of 32-bit integers.
+ *
+ * @param vector [in] The vector
+ * @return The smallest lane
+ */
+__attribute__((target("avx2"))) static int minLanes(__m256i vector)
+{
+    __m128i min = _mm_min_epi32(_mm256_castsi256_si128(vector), _mm256_extracti128_si256(vector, 1));
+    min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+    min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(min);
+}
+
+/**
+ * @brief Reads the bits of a selection for 8 consecutive rows.
+ *
+ * @param selection [in] A selection
+ * @param row [in] The first of the rows
+ * @return A byte with bit i set if row 'row' + i is selected
+ */
+static unsigned int selectedRows(const Selection *selection, int row)
+{
+    int word = row / SELECTION_WORD_BITS, shift = row % SELECTION_WORD_BITS;
+    uint64_t bits = selection->words[word] >> shift;
+    if (shift > SELECTION_WORD_BITS - 8 && word + 1 < selectionWords(selection->size))
+        bits |= selection->words[word + 1] << (SELECTION_WORD_BITS - shift);
+    return (unsigned int)(bits & 0xFF);
+}
+
+/**
+ * @brief Accumulates the statistics of a range of rows 8 rows at a time with AVX2, finishing the last partial block with accumulateScalar.
+ * <br>Comparisons give lanes of all ones (-1), so a count is kept by subtracting masks. Instead of finding the band of each age,
+ * the kernel counts the ages up to the end of each band, and the bands are the differences between consecutive counts.
+ * Rows outside the selection are masked out of the sex and status comparisons.
+ *
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The rows to include, or NULL for all
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param stats [in] The statistics to accumulate into
+ */
+__attribute__((target("avx2"))) static void accumulateAVX2(const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats)
+{
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i unknownYear = _mm256_set1_epi32(-1);
+    const __m256i currentYear = _mm256_set1_epi32(2020);
+    const __m256i noYear = _mm256_set1_epi32(INT_MAX);
+    const __m256i maleCode = _mm256_set1_epi32(store->maleCode);
+    const __m256i femaleCode = _mm256_set1_epi32(store->femaleCode);
+    const __m256i statusCodes[STATUS_COLUMNS] = {_mm256_set1_epi32(store->isolatedCode), _mm256_set1_epi32(store->deceasedCode),
+                                                 _mm256_set1_epi32(store->releasedCode)};
+    __m256i bandLimits[AGE_BANDS];
+    for (int band = 0; band < AGE_BANDS; band++)
+        bandLimits[band] = _mm256_set1_epi32(bandEnds[band] + 1);
+
+    __m256i males = _mm256_setzero_si256(), females = _mm256_setzero_si256();
+    __m256i earliestMale = noYear, earliestFemale = noYear;
+    __m256i agedCounts[STATUS_COLUMNS], ageSums[STATUS_COLUMNS][2], agesUpToBandEnd[AGE_BANDS][STATUS_COLUMNS];
+    for (int column = 0; column < STATUS_COLUMNS; column++)
+    {
+        agedCounts[column] = _mm256_setzero_si256();
+        ageSums[column][0] = ageSums[column][1] = _mm256_setzero_si256(); //Sums are kept in 64-bit lanes, for the low and the high 4 rows
+        for (int band = 0; band < AGE_BANDS; band++)
+            agesUpToBandEnd[band][column] = _mm256_setzero_si256();
+    }
+
+    __m256i selected = unknownYear; //All ones
+    int selectedCount = 0;
+    int i = begin;
+    for (; end - i >= 8; i += 8)
+    {
+        if (selection != NULL)
+        {
+            unsigned int bits = selectedRows(selection, i);
+            selected = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(bits), laneBits), laneBits);
+            selectedCount += __builtin_popcount(bits);
+        }
+        __m256i sexes = _mm256_loadu_si256((const __m256i *)&store->sexCodes[i]);
+        __m256i birthYears = _mm256_loadu_si256((const __m256i *)&store->birthYears[i]);
+        __m256i statuses = _mm256_loadu_si256((const __m256i *)&store->statusCodes[i]);
+
+        __m256i known = _mm256_andnot_si256(_mm256_cmpeq_epi32(birthYears, unknownYear), selected);
+        __m256i knownYears = _mm256_blendv_epi8(noYear, birthYears, known);
+
+        __m256i isMale = _mm256_and_si256(selected, _mm256_cmpeq_epi32(sexes, maleCode));
+        __m256i isFemale = _mm256_and_si256(selected, _mm256_cmpeq_epi32(sexes, femaleCode));
+        males = _mm256_sub_epi32(males, isMale);
+        females = _mm256_sub_epi32(females, isFemale);
+        earliestMale = _mm256_min_epi32(earliestMale, _mm256_blendv_epi8(noYear, knownYears, isMale));
+        earliestFemale = _mm256_min_epi32(earliestFemale, _mm256_blendv_epi8(noYear, knownYears, isFemale));
+
+        __m256i ages = _mm256_sub_epi32(currentYear, birthYears);
+        __m256i notNegative = _mm256_cmpgt_epi32(ages, unknownYear);
+        __m256i upToBandEnd[AGE_BANDS];
+        for (int band = 0; band < AGE_BANDS; band++)
+            upToBandEnd[band] = _mm256_and_si256(notNegative, _mm256_cmpgt_epi32(bandLimits[band], ages));
+
+        for (int column = 0; column < STATUS_COLUMNS; column++)
+        {
+            __m256i inColumn = _mm256_and_si256(known, _mm256_cmpeq_epi32(statuses, statusCodes[column]));
+            agedCounts[column] = _mm256_sub_epi32(agedCounts[column], inColumn);
+
+            __m256i columnAges = _mm256_and_si256(ages, inColumn);
+            ageSums[column][0] = _mm256_add_epi64(ageSums[column][0], _mm256_cvtepi32_epi64(_mm256_castsi256_si128(columnAges)));
+            ageSums[column][1] = _mm256_add_epi64(ageSums[column][1], _mm256_cvtepi32_epi64(_mm256_extracti128_si256(columnAges, 1)));
+
+            for (int band = 0; band < AGE_BANDS; band++)
+                agesUpToBandEnd[band][column] = _mm256_sub_epi32(agesUpToBandEnd[band][column], _mm256_and_si256(upToBandEnd[band], inColumn));
+        }
+    }
+
+    int maleCount = sumLanes(males), femaleCount = sumLanes(females);
+    stats->maleCount += maleCount;
+    stats->femaleCount += femaleCount;
+    stats->unknownSexCount += (selection != NULL ? selectedCount : i - begin) - maleCount - femaleCount;
+
+    int year = minLanes(earliestMale);
+    if (year < stats->earliestMaleYear)
+        stats->earliestMaleYear = year;
+    year = minLanes(earliestFemale);
+    if (year < stats->earliestFemaleYear)
+        stats->earliestFemaleYear = year;
+
+    for (int column = 0; column < STATUS_COLUMNS; column++)
+    {
+        stats->agedCountByStatus[column] += sumLanes(agedCounts[column]);
+
+        long long sums[4];
+        _mm256_storeu_si256((__m256i *)sums, _mm256_add_epi64(ageSums[column][0], ageSums[column][1]));
+        stats->ageSumByStatus[column] += sums[0] + sums[1] + sums[2] + sums[3];
+
+        int previous = 0;
+        for (int band = 0; band < AGE_BANDS; band++)
+        {
+            int upToEnd = sumLanes(agesUpToBandEnd[band][column]);
+            stats->ageBandByStatus[band][column] += upToEnd - previous;
+            previous = upToEnd;
+        }
+    }
+
+    accumulateScalar(store, selection, i, end, stats);
+}
+#endif
+
+/** The kernels, indexed by STATS_KERNEL_SCALAR and STATS_KERNEL_AVX2. Those the build can't provide fall back to accumulateScalar. */
+#ifdef KERNELS_X86
+static void (*const kernels[STATS_KERNELS])(const PatientStore *, const Selection *, int, int, PatientStats *) = {accumulateScalar, accumulateAVX2};
+#else
+static void (*const kernels[STATS_KERNELS])(const PatientStore *, const Selection *, int, int, PatientStats *) = {accumulateScalar, accumulateScalar};
+#endif
+
+/** The widest kernel supported by the processor, picked by selectKernel. */
+static int bestKernel = STATS_KERNEL_SCALAR;
+static pthread_once_t kernelSelected = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Picks the widest kernel supported by the processor.
+ *
+ */
+static void selectKernel(void)
+{
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        bestKernel = STATS_KERNEL_AVX2;
+#endif
+}
+
+bool patientStatsKernelSupported(int kernel)
+{
+    pthread_once(&kernelSelected, selectKernel);
+    return kernel >= STATS_KERNEL_SCALAR && kernel <= bestKernel;
+}
+
+void accumulatePatientStatsWith(int kernel, const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats)
+{
+    kernels[kernel](store, selection, begin, end, stats);
+}
+
+void accumulatePatientStats(const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats)
+{
+    pthread_once(&kernelSelected, selectKernel);
+    kernels[bestKernel](store, selection, begin, end, stats);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file patientStatsKernels.h
+ * @author Pedro Vitória
+ * @brief Defines the kernel that accumulates the statistics of a patient store (see PatientStats) over a range of rows.
+ * <br>The kernel reads the sex, birth year and status columns once, and builds the sex counts, the earliest birth years and the age band × status histogram together.
+ * It handles 8 rows at a time with AVX2, picked at runtime according to the processor, and falls back to a scalar loop elsewhere.
+ */
+
+#pragma once
+
+#include "patientStore.h"
+
+#define STATS_KERNEL_SCALAR 0
+#define STATS_KERNEL_AVX2 1
+
+/** The number of kernels the statistics can be accumulated with. */
+#define STATS_KERNELS 2
+
+/**
+ * @brief Finds the age band of an age, as shown by the MATRIX command.
+ *
+ * @param age [in] The age of a patient
+ * @return The index of the age band, or
+ * @return -1 if the age falls outside every band
+ */
+int patientAgeBand(int age);
+
+/**
+ * @brief Accumulates the statistics of a range of rows of a store into a set of statistics.
+ * <br>Counts and sums are added to those already in 'stats', and the earliest birth years are only lowered.
+ *
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The rows to include, or NULL for all
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param stats [in] The statistics to accumulate into
+ */
+void accumulatePatientStats(const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats);
+
+/**
+ * @brief Checks if the processor supports a kernel.
+ *
+ * @param kernel [in] STATS_KERNEL_SCALAR or STATS_KERNEL_AVX2
+ * @return true if the statistics can be accumulated with the kernel or,
+ * @return false otherwise
+ */
+bool patientStatsKernelSupported(int kernel);
+
+/**
+ * @brief Accumulates the statistics of a range of rows with a given kernel, as accumulatePatientStats does with the widest one.
+ * <br>Every kernel accumulates the same statistics; this lets them be checked against each other.
+ *
+ * @param kernel [in] The kernel to use, which the processor must support (see patientStatsKernelSupported)
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The rows to include, or NULL for all
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param stats [in] The statistics to accumulate into
+ */
+void accumulatePatientStatsWith(int kernel, const PatientStore *store, const Selection *selection, int begin, int end, PatientStats *stats);
@@ -0,0 +1,316 @@
+/**
+ * @file patientStore.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>PatientStore</i></b> data type
+ */
+
+#include "patientStore.h"
+#include "workerPool.h"
+#include "patientStatsKernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Resolves the codes of the values the commands test for, once the dictionaries of a store are set.
+ * 
+ * @param store [in] A columnar store of patients
+ */
+static void resolveCodes(PtPatientStore store)
+{
+    store->maleCode = dictionaryFind(store->dictionaries.sexes, "male");
+    store->femaleCode = dictionaryFind(store->dictionaries.sexes, "female");
+    store->isolatedCode = dictionaryFind(store->dictionaries.statuses, "isolated");
+    store->deceasedCode = dictionaryFind(store->dictionaries.statuses, "deceased");
+    store->releasedCode = dictionaryFind(store->dictionaries.statuses, "released");
+}
+
+PtPatientStore patientStoreCreate(PtList patientsList, PatientDictionaries *dictionaries)
+{
+    PtPatientStore store = patientsList != NULL ? (PtPatientStore)calloc(1, sizeof(PatientStore)) : NULL;
+    if (store == NULL)
+    {
+        patientDictionariesDestroy(dictionaries);
+        return NULL;
+    }
+    store->dictionaries = *dictionaries;
+    memset(dictionaries, 0, sizeof(*dictionaries)); //The store owns them from now on.
+
+    int size = 0;
+    listSize(patientsList, &size);
+
+    //Allocate at least one row, so that a NULL column always means an allocation failure.
+    //All the columns are carved out of a single block of the store's arena, and released together with it.
+    size_t rows = size > 0 ? size : 1;
+    size_t rowSize = sizeof(*store->ids) + sizeof(*store->birthYears) + sizeof(*store->infectedBy) + sizeof(*store->confirmedDays) +
+                     sizeof(*store->releasedDays) + sizeof(*store->deceasedDays) + sizeof(*store->sexCodes) + sizeof(*store->countryCodes) +
+                     sizeof(*store->regionCodes) + sizeof(*store->infectionReasonCodes) + sizeof(*store->statusCodes) + sizeof(*store->regionIds);
+    datasetArenaReserve(&store->arena, rows * rowSize + PATIENT_STORE_COLUMNS * (DATASET_ARENA_ALIGNMENT - 1));
+
+    store->ids = datasetArenaAlloc(&store->arena, rows * sizeof(*store->ids));
+    store->birthYears = datasetArenaAlloc(&store->arena, rows * sizeof(*store->birthYears));
+    store->infectedBy = datasetArenaAlloc(&store->arena, rows * sizeof(*store->infectedBy));
+    store->confirmedDays = datasetArenaAlloc(&store->arena, rows * sizeof(*store->confirmedDays));
+    store->releasedDays = datasetArenaAlloc(&store->arena, rows * sizeof(*store->releasedDays));
+    store->deceasedDays = datasetArenaAlloc(&store->arena, rows * sizeof(*store->deceasedDays));
+    store->sexCodes = datasetArenaAlloc(&store->arena, rows * sizeof(*store->sexCodes));
+    store->countryCodes = datasetArenaAlloc(&store->arena, rows * sizeof(*store->countryCodes));
+    store->regionCodes = datasetArenaAlloc(&store->arena, rows * sizeof(*store->regionCodes));
+    store->infectionReasonCodes = datasetArenaAlloc(&store->arena, rows * sizeof(*store->infectionReasonCodes));
+    store->statusCodes = datasetArenaAlloc(&store->arena, rows * sizeof(*store->statusCodes));
+    store->regionIds = datasetArenaAlloc(&store->arena, rows * sizeof(*store->regionIds));
+
+    if (store->ids == NULL || store->birthYears == NULL || store->infectedBy == NULL || store->confirmedDays == NULL ||
+        store->releasedDays == NULL || store->deceasedDays == NULL || store->sexCodes == NULL || store->countryCodes == NULL ||
+        store->regionCodes == NULL || store->infectionReasonCodes == NULL || store->statusCodes == NULL || store->regionIds == NULL)
+    {
+        patientStoreDestroy(&store);
+        return NULL;
+    }
+
+    const ListElem *patients;
+    listSpan(patientsList, &patients, &size);
+    for (int i = 0; i < size; i++)
+    {
+        const ListElem *patient = &patients[i];
+        store->ids[i] = patient->id;
+        store->birthYears[i] = patient->birthYear;
+        store->infectedBy[i] = patient->infectedBy;
+        store->confirmedDays[i] = patient->confirmedDate.epochDay;
+        store->releasedDays[i] = patient->releasedDate.epochDay;
+        store->deceasedDays[i] = patient->deceasedDate.epochDay;
+        store->sexCodes[i] = patient->sexCode;
+        store->countryCodes[i] = patient->countryCode;
+        store->regionCodes[i] = patient->regionCode;
+        store->infectionReasonCodes[i] = patient->infectionReasonCode;
+        store->statusCodes[i] = patient->statusCode;
+        store->regionIds[i] = -1;
+    }
+    store->size = size;
+    store->patientsWithoutRegion = size;
+
+    if (!infectionGraphBuild(&store->infections, patientsList, &store->arena) ||
+        !dailySeriesBuild(&store->days, store->confirmedDays, store->releasedDays, store->deceasedDays, size, &store->arena))
+    {
+        patientStoreDestroy(&store);
+        return NULL;
+    }
+
+    resolveCodes(store);
+    return store;
+}
+
+PtPatientStore patientStoreCreateMapped(PatientStore *columns, MappedFile *mapping)
+{
+    PtPatientStore store = (PtPatientStore)malloc(sizeof(PatientStore));
+    if (store == NULL)
+    {
+        free(columns->regionValues);
+        patientDictionariesDestroy(&columns->dictionaries);
+        mappedFileClose(mapping);
+        return NULL;
+    }
+    *store = *columns;
+    memset(&store->arena, 0, sizeof(store->arena));
+    store->hasStats = false;
+    store->mapping = *mapping;
+    memset(columns, 0, sizeof(*columns)); //The store owns them from now on.
+    memset(mapping, 0, sizeof(*mapping));
+
+    if (!infectionGraphAttach(&store->infections, &store->arena))
+    {
+        patientStoreDestroy(&store);
+        return NULL;
+    }
+
+    resolveCodes(store);
+    return store;
+}
+
+/**
+ * @brief Checks if a column of a patient store points into the snapshot the store was opened from, and so can't be written.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param column [in] The column
+ * @return true if the column is mapped or,
+ * @return false otherwise
+ */
+static bool isMapped(PtPatientStore store, const void *column)
+{
+    const char *address = (const char *)column;
+    return store->mapping.contents != NULL && address >= store->mapping.contents && address < store->mapping.contents + store->mapping.size;
+}
+
+/**
+ * @brief Unlinks a patient store from its map of regions, leaving every patient without a region id.
+ * 
+ * @param store [in] A columnar store of patients
+ */
+static void unlinkRegions(PtPatientStore store)
+{
+    free(store->regionValues);
+    store->regionValues = NULL;
+    store->regionCount = 0;
+
+    for (int i = 0; i < store->size; i++)
+        store->regionIds[i] = -1;
+    store->patientsWithoutRegion = store->size;
+}
+
+bool patientStoreLinkRegions(PtPatientStore store, PtMap regionsMap)
+{
+    //The region ids of a mapped snapshot are read-only, so the store gets region ids of its own the first time it is linked again.
+    if (isMapped(store, store->regionIds))
+    {
+        int *regionIds = datasetArenaAlloc(&store->arena, (store->size > 0 ? store->size : 1) * sizeof(int));
+        if (regionIds == NULL)
+            return false;
+        store->regionIds = regionIds;
+    }
+    unlinkRegions(store);
+
+    int numberOfRegionCodes = dictionarySize(store->dictionaries.regions);
+    int *regionIdsByCode = (int *)malloc((numberOfRegionCodes > 0 ? numberOfRegionCodes : 1) * sizeof(int));
+    if (regionIdsByCode == NULL)
+        return false;
+    for (int code = 0; code < numberOfRegionCodes; code++)
+        regionIdsByCode[code] = -1;
+
+    int regionCount = 0;
+    if (regionsMap != NULL && !mapIsEmpty(regionsMap))
+    {
+        //The store keeps the copy of the regions made by mapValues, until it is linked again or destroyed.
+        store->regionValues = mapValues(regionsMap);
+        if (store->regionValues == NULL)
+        {
+            free(regionIdsByCode);
+            return false;
+        }
+        mapSize(regionsMap, &regionCount);
+        store->regionCount = regionCount;
+    }
+
+    //Each region of the map is looked up once in the dictionary, then each patient only indexes the table of codes.
+    for (int id = 0; id < regionCount; id++)
+    {
+        int code = dictionaryFind(store->dictionaries.regions, store->regionValues[id].name);
+        if (code != DICTIONARY_UNKNOWN)
+            regionIdsByCode[code] = id;
+    }
+
+    store->patientsWithoutRegion = 0;
+    for (int i = 0; i < store->size; i++)
+    {
+        store->regionIds[i] = regionIdsByCode[store->regionCodes[i]];
+        if (store->regionIds[i] == -1)
+            store->patientsWithoutRegion++;
+    }
+
+    free(regionIdsByCode);
+    return true;
+}
+
+/**
+ * @brief The context of a scan for statistics, for parallelReduce.
+ * 
+ */
+typedef struct statsScan
+{
+    PtPatientStore store;
+    const Selection *selection; //The patients to include, or NULL for all
+} StatsScan;
+
+/**
+ * @brief Accumulates the statistics of a range of rows of a store, for parallelReduce.
+ * 
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param partial [in] The statistics (PatientStats *) to accumulate into
+ * @param context [in] The scan (StatsScan *)
+ */
+static void accumulateStats(int begin, int end, void *partial, void *context)
+{
+    StatsScan *scan = (StatsScan *)context;
+    accumulatePatientStats(scan->store, scan->selection, begin, end, (PatientStats *)partial);
+}
+
+/**
+ * @brief Merges the statistics of a range of rows into the statistics of the store, for parallelReduce.
+ * 
+ * @param result [in] The statistics (PatientStats *) of the store
+ * @param partial [in] The statistics (const PatientStats *) of the range
+ * @param context [in] The scan (StatsScan *)
+ */
+static void mergeStats(void *result, const void *partial, void *context)
+{
+    PatientStats *stats = (PatientStats *)result;
+    const PatientStats *range = (const PatientStats *)partial;
+
+    stats->maleCount += range->maleCount;
+    stats->femaleCount += range->femaleCount;
+    stats->unknownSexCount += range->unknownSexCount;
+    for (int column = 0; column < STATUS_COLUMNS; column++)
+    {
+        stats->agedCountByStatus[column] += range->agedCountByStatus[column];
+        stats->ageSumByStatus[column] += range->ageSumByStatus[column];
+        for (int band = 0; band < AGE_BANDS; band++)
+            stats->ageBandByStatus[band][column] += range->ageBandByStatus[band][column];
+    }
+    if (range->earliestMaleYear < stats->earliestMaleYear)
+        stats->earliestMaleYear = range->earliestMaleYear;
+    if (range->earliestFemaleYear < stats->earliestFemaleYear)
+        stats->earliestFemaleYear = range->earliestFemaleYear;
+}
+
+/**
+ * @brief Computes the statistics of some of the patients of a store.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to include, or NULL for all
+ * @param stats [out] The statistics
+ */
+static void computeStats(PtPatientStore store, const Selection *selection, PatientStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    //The search for the earliest birth years starts from the first patient, or from 2000 if their birth year is unknown.
+    int first = selectionFirst(selection, store->size);
+    int firstYear = (first != -1 && store->birthYears[first] != -1 ? store->birthYears[first] : 2000);
+    stats->earliestMaleYear = firstYear;
+    stats->earliestFemaleYear = firstYear;
+
+    StatsScan scan = {store, selection};
+    parallelReduce(workerPoolShared(), store->size, sizeof(PatientStats), accumulateStats, mergeStats, stats, &scan);
+}
+
+const PatientStats *patientStoreStats(PtPatientStore store)
+{
+    if (!store->hasStats)
+    {
+        computeStats(store, NULL, &store->stats);
+        store->hasStats = true;
+    }
+    return &store->stats;
+}
+
+void patientStoreSelectionStats(PtPatientStore store, const Selection *selection, PatientStats *stats)
+{
+    if (selection == NULL)
+        *stats = *patientStoreStats(store);
+    else
+        computeStats(store, selection, stats);
+}
+
+void patientStoreDestroy(PtPatientStore *ptStore)
+{
+    PtPatientStore store = *ptStore;
+    if (store == NULL)
+        return;
+
+    datasetArenaRelease(&store->arena);
+    free(store->regionValues);
+    patientDictionariesDestroy(&store->dictionaries);
+    mappedFileClose(&store->mapping);
+    free(store);
+
+    *ptStore = NULL;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file patientStore.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>PatientStore</i></b> and related operations.
+ * <br>A patient store holds the same patients as a list of patients, laid out as one contiguous array (column) per field,
+ * so that a scan over some fields only touches the memory of those fields. Row <b>i</b> of every column belongs to the patient at rank <b>i</b> of the list.
+ */
+
+#pragma once
+
+#include "list.h"
+#include "map.h"
+#include "dictionary.h"
+#include "datasetArena.h"
+#include "infectionGraph.h"
+#include "dailySeries.h"
+#include "selection.h"
+#include "mappedFile.h"
+
+#define AGE_BANDS 6        /* [0-15], [16-30], [31-45], [46-60], [61-75], [76-152] */
+#define STATUS_ISOLATED 0  /* Column of the isolated patients in the statistics by status */
+#define STATUS_DECEASED 1  /* Column of the deceased patients in the statistics by status */
+#define STATUS_RELEASED 2  /* Column of the released patients in the statistics by status */
+#define STATUS_COLUMNS 3
+
+#define PATIENT_STORE_COLUMNS 12  /* Number of columns of a patient store, which share a single block of its arena */
+
+/**
+ * @brief Holds the statistics of a patient store that the AVERAGE, SEX, OLDEST and MATRIX commands report.
+ * <br>They are all computed together, in a single scan of the store split among the threads of the shared worker pool (see parallelReduce). Ages are taken as of 2020.
+ * 
+ */
+typedef struct patientStats
+{
+    int maleCount;
+    int femaleCount;
+    int unknownSexCount;
+
+    int agedCountByStatus[STATUS_COLUMNS];     /* Patients of each status whose birth year is known */
+    long long ageSumByStatus[STATUS_COLUMNS];  /* Sum of the ages of those patients */
+
+    int ageBandByStatus[AGE_BANDS][STATUS_COLUMNS];
+
+    int earliestMaleYear;
+    int earliestFemaleYear;
+} PatientStats;
+
+/**
+ * @brief Represents a columnar store of patients.
+ * <br>Dates are stored as epoch days (see Date), where 0 stands for an unknown date.
+ * <br>The string fields are dictionary-encoded: each column stores the code of the string in the dictionary of that column, from which the string can be retrieved for printing.
+ * The codes are those of the list of patients, whose dictionaries the store owns.
+ * The codes of the values the commands test for are resolved once, when the store is created, so that tests like "is this patient isolated?" are integer comparisons.
+ * A value that doesn't occur in the data has the code DICTIONARY_UNKNOWN, which never matches a row.
+ * <br>The store also holds the infection graph of the patients (see InfectionGraph).
+ * <br>The columns and the infection graph live in the arena of the store, so destroying the store releases them at once,
+ * and <b>arena.allocated</b> is the memory they take. The linked regions are allocated apart, since they are replaced whenever the store is linked again.
+ * <br>Once linked to a map of regions (see patientStoreLinkRegions), the store also holds the id of the region of each patient, i.e., the index of the region in
+ * <b>regionValues</b>, so that joining patients with regions is array indexing.
+ * <br>A store opened from a snapshot (see patientStoreCreateMapped) uses the columns, infection graph, daily series and region ids of the snapshot in place,
+ * straight from <b>mapping</b>: they are read-only, and the arena only holds what the store writes.
+ * 
+ */
+typedef struct patientStore
+{
+    DatasetArena arena;
+
+    int size;
+    long int *ids;
+    int *birthYears;
+    long int *infectedBy;
+    int *confirmedDays;
+    int *releasedDays;
+    int *deceasedDays;
+
+    int *sexCodes;
+    int *countryCodes;
+    int *regionCodes;
+    int *infectionReasonCodes;
+    int *statusCodes;
+
+    PatientDictionaries dictionaries; /* Those of the list of patients, which the store owns */
+
+    int maleCode;
+    int femaleCode;
+    int isolatedCode;
+    int deceasedCode;
+    int releasedCode;
+
+    int *regionIds;             /* Id of the region of each patient, or -1 if the region isn't in the linked map */
+    MapValue *regionValues;     /* Regions of the linked map, in the order of mapValues */
+    int regionCount;
+    int patientsWithoutRegion;  /* Number of patients whose region isn't in the linked map */
+
+    InfectionGraph infections;  /* Who infected whom, by row */
+    DailySeries days;           /* Confirmations, releases and deaths per day */
+
+    bool hasStats;       /* Whether 'stats' has already been computed */
+    PatientStats stats;
+
+    MappedFile mapping;  /* The snapshot the store was opened from, if any, which the store owns */
+} PatientStore;
+
+/** Definition of pointer to the data structure. */
+typedef PatientStore *PtPatientStore;
+
+/**
+ * @brief Creates a new patient store holding the patients of a list.
+ * <br>The store takes over the dictionaries the string fields of the patients are encoded with, so it must live as long as the list does.
+ * 
+ * @param patientsList [in] A list of patients
+ * @param dictionaries [in] The dictionaries of the patients. They are released with the store, or right away if the store can't be created
+ * @return PtPatientStore pointer to the newly created store, or
+ * @return NULL if 'patientsList' is NULL or if there is insufficient memory for allocation
+ */
+PtPatientStore patientStoreCreate(PtList patientsList, PatientDictionaries *dictionaries);
+
+/**
+ * @brief Creates a new patient store over columns that already exist, without copying them, such as those of a snapshot mapped into memory.
+ * <br>The store takes over the mapped file, and unmaps it when destroyed, so any list sharing the patients of the mapping must be destroyed first.
+ * 
+ * @param columns [in] A store whose size, columns, infection graph (but its marks), daily series, dictionaries, linked regions and patientsWithoutRegion are set.
+ * Its dictionaries and regionValues are taken over, like the mapped file, and are released with the store, or right away if the store can't be created
+ * @param mapping [in] The mapped file the columns point into
+ * @return PtPatientStore pointer to the newly created store, or
+ * @return NULL if there is insufficient memory for allocation
+ */
+PtPatientStore patientStoreCreateMapped(PatientStore *columns, MappedFile *mapping);
+
+/**
+ * @brief Links a patient store to a map of regions, resolving the region of each patient to a region id.
+ * <br>It must be called again whenever either the patients or the regions are (re)loaded.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param regionsMap [in] A map of regions. If NULL or empty, no patient has a region id
+ * @return true if the store was successfully linked or,
+ * @return false if insufficient memory for allocation, in which case no patient has a region id,
+ * unless the store uses the region ids of a mapped snapshot, which are then left as they are
+ */
+bool patientStoreLinkRegions(PtPatientStore store, PtMap regionsMap);
+
+/**
+ * @brief Retrieves the statistics of a patient store, computing them on the first call.
+ * <br>A store is rebuilt whenever the patients are (re)loaded, so the cached statistics never outlive the data they describe.
+ * 
+ * @param store [in] A columnar store of patients
+ * @return const PatientStats* pointer to the statistics, owned by the store
+ */
+const PatientStats *patientStoreStats(PtPatientStore store);
+
+/**
+ * @brief Computes the statistics of the patients of a store in a selection, such as those matching a WHERE condition.
+ * <br>Unlike those of the whole store, they are not cached.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to include, or NULL for all (the cached statistics of the store)
+ * @param stats [out] The statistics
+ */
+void patientStoreSelectionStats(PtPatientStore store, const Selection *selection, PatientStats *stats);
+
+/**
+ * @brief Free all resources of a patient store.
+ * 
+ * @param ptStore [in] ADDRESS OF pointer to the store. Nothing happens if '*ptStore' is NULL
+ */
+void patientStoreDestroy(PtPatientStore *ptStore);
@@ -7,13 +7,15 @@
 #pragma once
 
 #include "utils.h"
+#include "patientStore.h"
 
 /**
  * @brief Searches for the index of a patient in the list of patients, returning it if found.
+ * Uses the ID index of the list, so the lookup takes constant time on average.
  * 
  * @param patientID [in] The patient ID to look for
- * @param startRank [in] The first index (rank) of the List
- * @param endRank [in] The last index (rank) of the List
+ * @param startRank [in] The first index (rank) of the List to consider
+ * @param endRank [in] One past the last index (rank) of the List to consider
  * @param patientsList [in] A list of patients
  * @return The index of the patient if sucessfully found, or 
  * @return -1 if not found
@@ -22,23 +24,27 @@ int findPatientIndex(PtList patientsList, long int patientID, int startRank, int
 
 /**
  * @brief Calculates and returns by reference the percentage of infected patients for each sex, including patients whose sex is unknown 
+ * <br>Reads the statistics of the store (see patientStoreStats), so it only scans the patients once per dataset, unless a selection is given.
  * 
- * @param patientsList [in] A list of patients
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to include, or NULL for all
  * @param malePercentage [out] The percentage pertaining to male patients, returned by reference
  * @param femalePercentage [out] The percentage pertaining to female patients, returned by reference
  * @param unknownPercentage [out] The percentage pertaining to patients for whom the sex is unknown, returned by reference
  */
-void calculatePercentageOfInfectedPatientsBySex(PtList patientsList, double *malePercentage, double *femalePercentage, double *unknownPercentage);
+void calculatePercentageOfInfectedPatientsBySex(PtPatientStore store, const Selection *selection, double *malePercentage, double *femalePercentage, double *unknownPercentage);
 
 /**
  * @brief Calculates and returns by reference the average age for isolated, deceased and released patients in a list of patients.
+ * <br>Reads the statistics of the store (see patientStoreStats), so it only scans the patients once per dataset, unless a selection is given.
  * 
- * @param patientsList [in] A list of patients
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to include, or NULL for all
  * @param averageIsolatedAge [out] The average age of isolated patients
  * @param averageDeceasedAge [out] The average age of deceased patients
  * @param averageReleasedAge [out] The average age of released patients
  */
-void calculateAverageAgeByState(PtList patientsList, double *averageIsolatedAge, double *averageDeceasedAge, double *averageReleasedAge);
+void calculateAverageAgeByState(PtPatientStore store, const Selection *selection, double *averageIsolatedAge, double *averageDeceasedAge, double *averageReleasedAge);
 
 /**
  * @brief Searches for a patient via the supplied ID and if found, returns said patient by reference.
@@ -53,71 +59,34 @@ bool getPatientByID(PtList patientsList, long int patientID, Patient *soughtPati
 
 /**
  * @brief Calculates the earliest birth year for both sexes in a list of patients.
+ * <br>Reads the statistics of the store (see patientStoreStats), so it only scans the patients once per dataset.
  * 
- * @param patientsList [in] A list of patients
+ * @param store [in] A columnar store of patients
  * @param earliestMaleYear [out] The earliest year for the male sex
  * @param earliestFemaleYear [out] The earliest year for the female sex
  */
-void calculateEarliestBirthYearBySex(PtList patientsList, int *earliestMaleYear, int *earliestFemaleYear);
-
-/**
- * @brief Calculates the number of isolated patients in a given age range.
- * 
- * @param patientsList [in] A list of patients
- * @param rangeStart [in] Beginning of the age range
- * @param rangeEnd [in] Ending of the age range
- * @return The number of isolated patients
- */
-int calculateIsolatedByAgeRange(PtList patientsList, int rangeStart, int rangeEnd);
-
-/**
- * @brief Calculates the number of deceased patients in a given age range.
- * 
- * @param patientsList [in] A list of patients
- * @param rangeStart [in] Beginning of the age range
- * @param rangeEnd [in] Ending of the age range
- * @return The number of deceased patients
- */
-int calculateDeceasedByAgeRange(PtList patientsList, int rangeStart, int rangeEnd);
-
-/**
- * @brief Calculates the number of released patients in a given age range.
- * 
- * @param patientsList [in] A list of patients
- * @param rangeStart [in] Beginning of the age range
- * @param rangeEnd [in] Ending of the age range
- * @return The number of released patients
- */
-int calculateReleasedByAgeRange(PtList patientsList, int rangeStart, int rangeEnd);
+void calculateEarliestBirthYearBySex(PtPatientStore store, int *earliestMaleYear, int *earliestFemaleYear);
 
 /**
  * @brief Retrieves the number of deaths with respect to the specified dates.
+ * <br>Reads the daily series of the store, so it takes constant time.
  * 
- * @param patientsList [in] A list of patients
+ * @param store [in] A columnar store of patients
  * @param currentDate [in] The current date
  * @param previousDate [in] The date before the current date
  * @param previousDeaths [out] The deaths with respect to the previous date
  * @param currentDeaths [out] The deaths with respect to the current date with the deaths of the previous date added as well
  */
-void deathsPreviousToCurrentDay(PtList patientsList, Date currentDate, Date previousDate, int *previousDeaths, int *currentDeaths);
+void deathsPreviousToCurrentDay(PtPatientStore store, Date currentDate, Date previousDate, int *previousDeaths, int *currentDeaths);
 
 /**
  * @brief Retrieves the number of isolated patients with respect to the specified dates.
+ * <br>Reads the daily series of the store, so it takes constant time.
  * 
- * @param patientsList [in] A list of patients
+ * @param store [in] A columnar store of patients
  * @param currentDate [in] The current date
  * @param previousDate [in] The date before the current date
  * @param previousIsolated [out] The number of isolated patients with respect to the previous date
  * @param currentIsolated [out] The number of isolated patients only with respect to the current date
  */
-void isolatedPreviousToCurrentDay(PtList patientsList, Date currentDate, Date previousDate, int *previousIsolated, int *currentIsolated);
-
-/**
- * @brief Filters the main patients list onto a new list, where the new list will only contain patients who have been released
- * 
- * @param patientsList [in] The main patient list
- * @param sizeAllPatientsList [in] The size of the main patient list
- * @param patientsReleasedList [out] The newly filtered list containing only patients whose status is released
- * @param sizeReleasedList [out] The size of the filtered list
- */
-void filterListByReleased(PtList patientsList, int sizeAllPatientsList, PtList *patientsReleasedList, int *sizeReleasedList);
+void isolatedPreviousToCurrentDay(PtPatientStore store, Date currentDate, Date previousDate, int *previousIsolated, int *currentIsolated);
@@ -0,0 +1,538 @@
+/**
+ * @file predicate.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>Predicate</i></b> data type
+ */
+
+#include "predicate.h"
+#include "workerPool.h"
+#include "fieldParsers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#define TOKEN_END 0
+#define TOKEN_WORD 1     //A word or a quoted value
+#define TOKEN_OPERATOR 2 //A comparison operator
+#define TOKEN_OPEN 3
+#define TOKEN_CLOSE 4
+#define TOKEN_INVALID 5
+
+#define FIELD_STRING 0
+#define FIELD_NUMBER 1
+#define FIELD_DATE 2
+#define FIELD_AGE 3
+
+/** The maximum length of a value of a condition. */
+#define MAX_VALUE_LENGTH 255
+
+/**
+ * @brief Represents a token of a condition.
+ *
+ */
+typedef struct token
+{
+    int type;
+    const char *start;
+    int length;
+    bool quoted;
+    int comparison; //For TOKEN_OPERATOR
+} Token;
+
+/**
+ * @brief Holds the state of the compilation of a condition.
+ *
+ */
+typedef struct parser
+{
+    PtPatientStore store;
+    const char *cursor; //Right after the current token
+    Token token;        //The current token
+    Predicate *predicate;
+    char *error;
+    size_t errorSize;
+    bool failed;
+} Parser;
+
+/**
+ * @brief Represents a field a condition can compare.
+ *
+ */
+typedef struct predicateField
+{
+    const char *name;
+    int kind;
+} PredicateField;
+
+static const PredicateField fields[] = {
+    {"sex", FIELD_STRING}, {"status", FIELD_STRING}, {"region", FIELD_STRING}, {"country", FIELD_STRING}, {"infection_case", FIELD_STRING},
+    {"age", FIELD_AGE}, {"birth_year", FIELD_NUMBER}, {"confirmed", FIELD_DATE}, {"released", FIELD_DATE}, {"deceased", FIELD_DATE}};
+
+/**
+ * @brief Records the first error of a compilation. Later errors are ignored, since they usually follow from the first.
+ *
+ * @param parser [in] The state of the compilation
+ * @param format [in] The message, as in printf
+ * @param token [in] The token the message refers to, inserted with "%.*s"
+ */
+static void fail(Parser *parser, const char *format, Token token)
+{
+    if (parser->failed)
+        return;
+    parser->failed = true;
+
+    if (token.type == TOKEN_END)
+        snprintf(parser->error, parser->errorSize, format, (int)strlen("end of condition"), "end of condition");
+    else
+        snprintf(parser->error, parser->errorSize, format, token.length, token.start);
+}
+
+/**
+ * @brief Reads the next token of a condition into the current token.
+ *
+ * @param parser [in] The state of the compilation
+ */
+static void nextToken(Parser *parser)
+{
+    const char *cursor = parser->cursor;
+    while (*cursor == ' ' || *cursor == '\t')
+        cursor++;
+
+    Token *token = &parser->token;
+    token->start = cursor;
+    token->length = 1;
+    token->quoted = false;
+
+    if (*cursor == '\0')
+    {
+        token->type = TOKEN_END;
+        token->length = 0;
+    }
+    else if (*cursor == '(' || *cursor == ')')
+    {
+        token->type = *cursor == '(' ? TOKEN_OPEN : TOKEN_CLOSE;
+    }
+    else if (*cursor == '"' || *cursor == '\'')
+    {
+        const char *close = strchr(cursor + 1, *cursor);
+        token->type = close != NULL ? TOKEN_WORD : TOKEN_INVALID;
+        token->quoted = true;
+        token->start = cursor + 1;
+        token->length = close != NULL ? close - token->start : (int)strlen(token->start);
+        cursor = close != NULL ? close : token->start + token->length - 1;
+    }
+    else if (strchr("=!<>", *cursor) != NULL)
+    {
+        bool equalFollows = cursor[1] == '=';
+        token->type = TOKEN_OPERATOR;
+        token->length = equalFollows || (cursor[0] == '<' && cursor[1] == '>') ? 2 : 1;
+        switch (*cursor)
+        {
+        case '=':
+            token->comparison = PREDICATE_EQUAL;
+            break;
+        case '!':
+            token->comparison = PREDICATE_NOT_EQUAL;
+            token->type = equalFollows ? TOKEN_OPERATOR : TOKEN_INVALID;
+            break;
+        case '<':
+            token->comparison = cursor[1] == '>' ? PREDICATE_NOT_EQUAL : equalFollows ? PREDICATE_LESS_EQUAL : PREDICATE_LESS;
+            break;
+        default:
+            token->comparison = equalFollows ? PREDICATE_GREATER_EQUAL : PREDICATE_GREATER;
+        }
+        cursor += token->length - 1;
+    }
+    else
+    {
+        token->type = TOKEN_WORD;
+        while (cursor[1] != '\0' && strchr(" \t()=!<>\"'", cursor[1]) == NULL)
+            cursor++;
+        token->length = cursor + 1 - token->start;
+    }
+
+    parser->cursor = *cursor != '\0' ? cursor + 1 : cursor;
+}
+
+/**
+ * @brief Checks if the current token is a given keyword.
+ *
+ * @param parser [in] The state of the compilation
+ * @param keyword [in] The keyword, in lowercase
+ * @return true if the current token is an unquoted word equal to the keyword, ignoring capitalization, or
+ * @return false otherwise
+ */
+static bool isKeyword(Parser *parser, const char *keyword)
+{
+    Token token = parser->token;
+    return token.type == TOKEN_WORD && !token.quoted && (int)strlen(keyword) == token.length && strncasecmp(token.start, keyword, token.length) == 0;
+}
+
+/**
+ * @brief Appends an instruction to the predicate being compiled.
+ *
+ * @param parser [in] The state of the compilation
+ * @param instruction [in] The instruction
+ */
+static void emit(Parser *parser, PredicateInstruction instruction)
+{
+    if (parser->failed)
+        return;
+    if (parser->predicate->length == PREDICATE_MAX_INSTRUCTIONS)
+    {
+        fail(parser, "the condition is too long%.*s", (Token){TOKEN_WORD, "", 0, false, 0});
+        return;
+    }
+    parser->predicate->instructions[parser->predicate->length++] = instruction;
+}
+
+/**
+ * @brief Finds the code of a string in a dictionary, ignoring capitalization if there is no exact match.
+ * <br>"unknown" stands for the empty string, unless the dictionary holds "unknown" itself.
+ *
+ * @param dictionary [in] The dictionary
+ * @param text [in] The string
+ * @return The code of the string, or
+ * @return DICTIONARY_UNKNOWN if the string is not in the dictionary
+ */
+static int findCode(PtDictionary dictionary, const char *text)
+{
+    int code = dictionaryFind(dictionary, text);
+    for (int i = 0; code == DICTIONARY_UNKNOWN && i < dictionarySize(dictionary); i++)
+    {
+        if (strcasecmp(dictionaryString(dictionary, i), text) == 0)
+            code = i;
+    }
+    if (code == DICTIONARY_UNKNOWN && strcasecmp(text, "unknown") == 0)
+        code = dictionaryFind(dictionary, "");
+    return code;
+}
+
+/**
+ * @brief Compiles a comparison: field operator value.
+ *
+ * @param parser [in] The state of the compilation
+ */
+static void parseComparison(Parser *parser)
+{
+    Token fieldToken = parser->token;
+    int field = -1;
+    for (int i = 0; i < (int)(sizeof(fields) / sizeof(fields[0])) && fieldToken.type == TOKEN_WORD && !fieldToken.quoted; i++)
+    {
+        if ((int)strlen(fields[i].name) == fieldToken.length && strncasecmp(fieldToken.start, fields[i].name, fieldToken.length) == 0)
+            field = i;
+    }
+    if (field == -1)
+    {
+        fail(parser, "expected a field, found '%.*s'", fieldToken);
+        return;
+    }
+    nextToken(parser);
+
+    int kind = fields[field].kind;
+    int comparison = parser->token.comparison;
+    if (kind == FIELD_DATE && (isKeyword(parser, "before") || isKeyword(parser, "after")))
+    {
+        comparison = isKeyword(parser, "before") ? PREDICATE_LESS : PREDICATE_GREATER;
+    }
+    else if (parser->token.type != TOKEN_OPERATOR)
+    {
+        fail(parser, "expected a comparison, found '%.*s'", parser->token);
+        return;
+    }
+    else if (kind == FIELD_STRING && comparison != PREDICATE_EQUAL && comparison != PREDICATE_NOT_EQUAL)
+    {
+        fail(parser, "'%.*s' can only be compared with = and !=", fieldToken);
+        return;
+    }
+    nextToken(parser);
+
+    Token valueToken = parser->token;
+    if (valueToken.type != TOKEN_WORD || valueToken.length > MAX_VALUE_LENGTH)
+    {
+        fail(parser, "expected a value, found '%.*s'", valueToken);
+        return;
+    }
+    char value[MAX_VALUE_LENGTH + 1];
+    memcpy(value, valueToken.start, valueToken.length);
+    value[valueToken.length] = '\0';
+    nextToken(parser);
+
+    PtPatientStore store = parser->store;
+    PredicateInstruction instruction = {PREDICATE_COMPARE, NULL, comparison, 0, -1};
+    if (kind == FIELD_STRING)
+    {
+        PtDictionary dictionaries[] = {store->dictionaries.sexes, store->dictionaries.statuses, store->dictionaries.regions, store->dictionaries.countries, store->dictionaries.infectionReasons};
+        const int *columns[] = {store->sexCodes, store->statusCodes, store->regionCodes, store->countryCodes, store->infectionReasonCodes};
+        instruction.column = columns[field];
+        instruction.value = findCode(dictionaries[field], value); //A value missing from the data is DICTIONARY_UNKNOWN, which matches no row.
+        instruction.unknownValue = DICTIONARY_UNKNOWN - 1;        //Every code is a known value.
+    }
+    else if (kind == FIELD_DATE)
+    {
+        Date date = parseDate(value, valueToken.length);
+        if (date.day < 1 || date.day > 31 || date.month < 1 || date.month > 12 || date.year < 1)
+        {
+            fail(parser, "'%.*s' is not a date (DD/MM/YYYY)", valueToken);
+            return;
+        }
+        const int *columns[] = {store->confirmedDays, store->releasedDays, store->deceasedDays};
+        instruction.column = columns[field - 7];
+        instruction.value = date.epochDay;
+        instruction.unknownValue = 0;
+    }
+    else
+    {
+        char *end;
+        long number = strtol(value, &end, 10);
+        if (*end != '\0' || number < 0 || number > 9999)
+        {
+            fail(parser, "'%.*s' is not a valid number", valueToken);
+            return;
+        }
+        instruction.column = store->birthYears;
+        instruction.value = (int)number;
+        if (kind == FIELD_AGE)
+        {
+            //age op n is birth_year op' 2020 - n, where op' is op mirrored, since age = 2020 - birth_year.
+            static const int mirrored[] = {PREDICATE_EQUAL, PREDICATE_NOT_EQUAL, PREDICATE_GREATER, PREDICATE_GREATER_EQUAL, PREDICATE_LESS, PREDICATE_LESS_EQUAL};
+            instruction.value = 2020 - instruction.value;
+            instruction.comparison = mirrored[comparison];
+        }
+    }
+    emit(parser, instruction);
+}
+
+static void parseCondition(Parser *parser);
+
+/**
+ * @brief Compiles a factor: NOT factor, ( condition ), or a comparison.
+ *
+ * @param parser [in] The state of the compilation
+ */
+static void parseFactor(Parser *parser)
+{
+    if (parser->failed)
+        return;
+
+    if (isKeyword(parser, "not"))
+    {
+        nextToken(parser);
+        parseFactor(parser);
+        emit(parser, (PredicateInstruction){PREDICATE_NOT, NULL, 0, 0, 0});
+    }
+    else if (parser->token.type == TOKEN_OPEN)
+    {
+        nextToken(parser);
+        parseCondition(parser);
+        if (parser->token.type != TOKEN_CLOSE)
+            fail(parser, "expected ')', found '%.*s'", parser->token);
+        nextToken(parser);
+    }
+    else
+    {
+        parseComparison(parser);
+    }
+}
+
+/**
+ * @brief Compiles a term: factor { AND factor }.
+ *
+ * @param parser [in] The state of the compilation
+ */
+static void parseTerm(Parser *parser)
+{
+    parseFactor(parser);
+    while (!parser->failed && isKeyword(parser, "and"))
+    {
+        nextToken(parser);
+        parseFactor(parser);
+        emit(parser, (PredicateInstruction){PREDICATE_AND, NULL, 0, 0, 0});
+    }
+}
+
+/**
+ * @brief Compiles a condition: term { OR term }.
+ *
+ * @param parser [in] The state of the compilation
+ */
+static void parseCondition(Parser *parser)
+{
+    parseTerm(parser);
+    while (!parser->failed && isKeyword(parser, "or"))
+    {
+        nextToken(parser);
+        parseTerm(parser);
+        emit(parser, (PredicateInstruction){PREDICATE_OR, NULL, 0, 0, 0});
+    }
+}
+
+bool predicateCompile(PtPatientStore store, const char *text, Predicate *predicate, char error[], size_t errorSize)
+{
+    Parser parser;
+    parser.store = store;
+    parser.cursor = text;
+    parser.predicate = predicate;
+    parser.error = error;
+    parser.errorSize = errorSize;
+    parser.failed = false;
+    predicate->length = 0;
+
+    nextToken(&parser);
+    parseCondition(&parser);
+    if (parser.token.type != TOKEN_END)
+        fail(&parser, "unexpected '%.*s'", parser.token);
+
+    return !parser.failed;
+}
+
+/**
+ * @brief Compares up to 64 consecutive rows of a column against the value of an instruction.
+ * <br>Each comparison is a loop of its own, which the compiler can vectorize.
+ *
+ * @param instruction [in] A PREDICATE_COMPARE instruction
+ * @param first [in] The first row
+ * @param rows [in] The number of rows, at most 64
+ * @param known [out] A mask with bit i set if the field of row first + i is known
+ * @return A mask with bit i set if row first + i matches
+ */
+static uint64_t compareRows(const PredicateInstruction *instruction, int first, int rows, uint64_t *known)
+{
+    const int *values = instruction->column + first;
+    int value = instruction->value;
+    int unknown = instruction->unknownValue;
+    uint64_t mask = 0;
+
+    switch (instruction->comparison)
+    {
+    case PREDICATE_EQUAL:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] == value && values[i] != unknown) << i;
+        break;
+    case PREDICATE_NOT_EQUAL:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] != value && values[i] != unknown) << i;
+        break;
+    case PREDICATE_LESS:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] < value && values[i] != unknown) << i;
+        break;
+    case PREDICATE_LESS_EQUAL:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] <= value && values[i] != unknown) << i;
+        break;
+    case PREDICATE_GREATER:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] > value && values[i] != unknown) << i;
+        break;
+    default:
+        for (int i = 0; i < rows; i++)
+            mask |= (uint64_t)(values[i] >= value && values[i] != unknown) << i;
+    }
+
+    *known = 0;
+    for (int i = 0; i < rows; i++)
+        *known |= (uint64_t)(values[i] != unknown) << i;
+    return mask;
+}
+
+/**
+ * @brief The outcome of a condition for up to 64 rows. A row can match, not match, or be unknown (as an unknown age compared to 30),
+ * in which case neither the condition nor its negation match it.
+ *
+ */
+typedef struct rowOutcomes
+{
+    uint64_t matching; //The rows for which the condition is true
+    uint64_t known;    //The rows for which the condition is either true or false
+} RowOutcomes;
+
+/**
+ * @brief The context of the evaluation of a predicate, for parallelReduce.
+ *
+ */
+typedef struct predicateScan
+{
+    const Predicate *predicate;
+    Selection *selection;
+} PredicateScan;
+
+/**
+ * @brief Runs a predicate over a range of words of a selection, counting the rows selected, for parallelReduce.
+ *
+ * @param begin [in] The first word of the range
+ * @param end [in] The word right after the last word of the range
+ * @param partial [in] The number (int *) of rows selected
+ * @param context [in] The evaluation (PredicateScan *)
+ */
+static void selectWords(int begin, int end, void *partial, void *context)
+{
+    const Predicate *predicate = ((PredicateScan *)context)->predicate;
+    Selection *selection = ((PredicateScan *)context)->selection;
+    RowOutcomes stack[PREDICATE_MAX_INSTRUCTIONS];
+
+    for (int w = begin; w < end; w++)
+    {
+        int first = w * SELECTION_WORD_BITS;
+        int rows = selection->size - first < SELECTION_WORD_BITS ? selection->size - first : SELECTION_WORD_BITS;
+
+        //Unknown outcomes follow three-valued logic: false AND unknown is false, true OR unknown is true, and anything else with unknown is unknown.
+        int top = 0;
+        for (int i = 0; i < predicate->length; i++)
+        {
+            const PredicateInstruction *instruction = &predicate->instructions[i];
+            if (instruction->opcode == PREDICATE_COMPARE)
+            {
+                stack[top].matching = compareRows(instruction, first, rows, &stack[top].known);
+                top++;
+            }
+            else if (instruction->opcode == PREDICATE_NOT)
+            {
+                stack[top - 1].matching = stack[top - 1].known & ~stack[top - 1].matching;
+            }
+            else
+            {
+                RowOutcomes *left = &stack[top - 2], *right = &stack[top - 1];
+                if (instruction->opcode == PREDICATE_AND)
+                {
+                    left->known = (left->known & right->known) | (left->known & ~left->matching) | (right->known & ~right->matching);
+                    left->matching &= right->matching;
+                }
+                else
+                {
+                    left->known = (left->known & right->known) | left->matching | right->matching;
+                    left->matching |= right->matching;
+                }
+                top--;
+            }
+        }
+
+        selection->words[w] = stack[0].matching;
+        *(int *)partial += __builtin_popcountll(stack[0].matching);
+    }
+}
+
+/**
+ * @brief Adds up the rows selected by a range of words, for parallelReduce.
+ *
+ * @param result [in] The number (int *) of rows selected by every word
+ * @param partial [in] The number (const int *) of rows selected by the range
+ * @param context [in] The evaluation (PredicateScan *)
+ */
+static void addCounts(void *result, const void *partial, void *context)
+{
+    *(int *)result += *(const int *)partial;
+}
+
+bool predicateSelect(PtPatientStore store, const Predicate *predicate, Selection *selection)
+{
+    if (!selectionCreate(selection, store->size))
+        return false;
+
+    //Tasks split the words, rather than the rows, so that no two tasks write to the same word.
+    PredicateScan scan = {predicate, selection};
+    parallelReduce(workerPoolShared(), selectionWords(store->size), sizeof(int), selectWords, addCounts, &selection->count, &scan);
+    return true;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file predicate.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>Predicate</i></b> and related operations.
+ * <br>A predicate is a condition on the patients of a store, such as <b>region = Seoul and confirmed after 01/03/2020</b>, as given to a <b>WHERE</b> clause.
+ * It is compiled once into a short program over the columns of the store: every value is resolved when compiling (strings to their dictionary code,
+ * dates to their epoch day, ages to birth years), so evaluating it only compares integers. The program runs 64 rows at a time and yields a Selection.
+ * <br>The grammar is:
+ * <ul>
+ * <li> condition := term { OR term }
+ * <li> term := factor { AND factor }
+ * <li> factor := NOT factor | ( condition ) | field operator value
+ * </ul>
+ * The fields are sex, status, region, country and infection_case, compared with = and !=, and age, birth_year, confirmed, released and deceased,
+ * compared with =, !=, &lt;, &lt;=, &gt; and &gt;=. Dates (DD/MM/YYYY) are also compared with <b>before</b> and <b>after</b>.
+ * Values with spaces are quoted. Keywords, fields and string values ignore capitalization, and <b>unknown</b> stands for an empty string field.
+ * A comparison never matches a patient whose age or date is unknown, and neither does its negation: <b>NOT age &gt; 30</b> only selects
+ * patients whose age is known and at most 30. Such a comparison only matters to AND and OR when the other side does not decide the outcome.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "patientStore.h"
+#include "selection.h"
+
+/** The maximum number of instructions of a predicate. */
+#define PREDICATE_MAX_INSTRUCTIONS 64
+
+#define PREDICATE_COMPARE 0
+#define PREDICATE_AND 1
+#define PREDICATE_OR 2
+#define PREDICATE_NOT 3
+
+#define PREDICATE_EQUAL 0
+#define PREDICATE_NOT_EQUAL 1
+#define PREDICATE_LESS 2
+#define PREDICATE_LESS_EQUAL 3
+#define PREDICATE_GREATER 4
+#define PREDICATE_GREATER_EQUAL 5
+
+/**
+ * @brief Represents an instruction of a predicate. The program is in postfix order, and runs over a stack of 64-row outcomes (see predicateSelect).
+ *
+ */
+typedef struct predicateInstruction
+{
+    int opcode;        //PREDICATE_COMPARE pushes an outcome, PREDICATE_AND and PREDICATE_OR combine the top two, PREDICATE_NOT negates the top one
+    const int *column; //The column compared by PREDICATE_COMPARE
+    int comparison;    //PREDICATE_EQUAL, PREDICATE_NOT_EQUAL, PREDICATE_LESS, PREDICATE_LESS_EQUAL, PREDICATE_GREATER or PREDICATE_GREATER_EQUAL
+    int value;         //The value compared against
+    int unknownValue;  //The value of the column for an unknown field, which never matches
+} PredicateInstruction;
+
+/**
+ * @brief Represents a compiled predicate.
+ *
+ */
+typedef struct predicate
+{
+    PredicateInstruction instructions[PREDICATE_MAX_INSTRUCTIONS];
+    int length;
+} Predicate;
+
+/**
+ * @brief Compiles the text of a condition on the patients of a store.
+ * <br>The predicate refers to the columns and dictionaries of the store, so it is only valid while the store is.
+ *
+ * @param store [in] A columnar store of patients
+ * @param text [in] The condition
+ * @param predicate [out] The compiled predicate
+ * @param error [out] Why the condition is not valid, if it isn't
+ * @param errorSize [in] The size of 'error', in bytes
+ * @return true if the condition was successfully compiled or,
+ * @return false if the condition is not valid
+ */
+bool predicateCompile(PtPatientStore store, const char *text, Predicate *predicate, char error[], size_t errorSize);
+
+/**
+ * @brief Selects the patients of a store that satisfy a predicate, 64 rows at a time, on the threads of the shared worker pool.
+ *
+ * @param store [in] The store the predicate was compiled for
+ * @param predicate [in] The predicate
+ * @param selection [out] The selected patients, to be destroyed by the caller (see selectionDestroy)
+ * @return true if the selection was successfully made or,
+ * @return false if insufficient memory for allocation
+ */
+bool predicateSelect(PtPatientStore store, const Predicate *predicate, Selection *selection);
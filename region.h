@@ -20,11 +20,15 @@ typedef struct region
 
 /**
  * @brief Represents the key type for the map of regions.
+ * <br>A key refers to its characters instead of holding them, and carries their length and hash, so that it is cheap to pass by value
+ * and most comparisons are decided without reading the characters. A map keeps its own copy of the characters of the keys it stores.
  * 
  */
 typedef struct keyString
 {
-    char contents[255];
+    const char *contents; //Not null-terminated, see length
+    int length;
+    unsigned int hash;
 } KeyString;
 
 /**
@@ -47,6 +51,7 @@ void regionPrint(Region region);
 
 /**
  * @brief Creates a new key for a given map of regions
+ * <br>The key refers to the string, which must outlive it, unless the key is only used to store a new mapping in a map.
  * 
  * @param keyContents [in] The string associated with the key
  * @return KeyString The newly created key
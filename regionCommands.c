@@ -5,31 +5,42 @@
  */
 
 #include "regionCommands.h"
+#include "mappedFile.h"
+#include "fieldParsers.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
 int importRegionsFromFile(char *filename, PtMap *map, int *numberOfRegionsReadFromFile)
 {
-    FILE *f = NULL;
-    f = fopen(filename, "r");
-    if (f == NULL)
+    MappedFile file;
+    if (!mappedFileOpen(filename, &file))
     {
         printf("File not found (%s)\n", filename);
         return FILE_NOT_FOUND;
     }
 
-    char nextline[1024];
     int countRegions = 0;
+    int rejected = 0;
+    int scanner = csvBestScanner();
     bool firstLine = true;
+    Field fields[REGION_FIELDS];
+    int fieldCount = 0;
 
+    mapDestroy(map); //Release the previously loaded regions, if any.
     *map = mapCreate(18);
-    if (map == NULL)
+    if (*map == NULL)
+    {
+        mappedFileClose(&file);
         return MAP_NULL;
+    }
 
-    while (fgets(nextline, sizeof(nextline), f))
+    const char *cursor = file.contents;
+    const char *end = file.contents + file.size;
+    while (cursor < end)
     {
-        if (strlen(nextline) < 1)
+        cursor = tokenizeLine(scanner, cursor, end, ';', fields, REGION_FIELDS, &fieldCount);
+        if (fieldCount == 1 && fields[0].length == 0)
             continue;
 
         if (firstLine)
@@ -37,39 +48,35 @@ int importRegionsFromFile(char *filename, PtMap *map, int *numberOfRegionsReadFr
             firstLine = false;
             continue;
         }
-
-        char **tokens = split(nextline, 4, ";");
-
-        replaceCharacter(tokens[2], ',', '.');
-
-        int index = 0;
-        char *population = tokens[3];
-        for (int i = 0; i < strlen(population); i++)
+        if (fieldCount != REGION_FIELDS)
         {
-            if (population[i] == ',')
-            {
-                index = i;
-                for (int j = index; j < strlen(population); j++)
-                {
-                    population[j] = population[j + 1];
-                }
-            }
+            rejected++;
+            continue;
         }
 
-        MapValue region = regionCreate(tokens[0], tokens[1], atoi(population), atof(tokens[2]));
+        MapValue region;
+        copyField(fields[0], region.name, sizeof(region.name));
+        copyField(fields[1], region.capital, sizeof(region.capital));
+        region.area = parseGroupedDecimal(fields[2].start, fields[2].length);
+        region.population = parseGroupedInteger(fields[3].start, fields[3].length);
+
         MapKey regionAsKey = mapKeyCreate(region.name);
 
         int error_code = mapPut(*map, regionAsKey, region);
-        free(tokens);
 
         if (error_code == MAP_FULL || error_code == MAP_UNKNOWN_KEY || error_code == MAP_NO_MEMORY || error_code == MAP_NULL)
         {
             printf("An error ocurred.... Please try again... \n");
+            mappedFileClose(&file);
             return error_code;
         }
         countRegions++;
     }
+    if (rejected > 0)
+    {
+        printf("\nSkipped %d line%s of %s without %d fields.\n", rejected, rejected == 1 ? "" : "s", filename, REGION_FIELDS);
+    }
     *numberOfRegionsReadFromFile = countRegions;
-    fclose(f);
+    mappedFileClose(&file);
     return FILE_OK;
 }
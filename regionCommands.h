@@ -9,10 +9,15 @@
 #define FILE_OK 0
 #define FILE_NOT_FOUND 1
 
+/** The number of fields in each line of the regions' file. */
+#define REGION_FIELDS 4
+
 #include "utils.h"
 
 /**
  * @brief Imports the contents of a file containing information about a certain amount of regions and stores it on a Map.
+ * <br>Population and area are read with their digits grouped in thousands by commas (e.g. 53,121,668).
+ * Lines that don't have REGION_FIELDS fields are skipped, and how many were skipped is shown.
  * 
  * @param filename [in] The name of the file
  * @param map [in] The instance of Map which will store the imported information
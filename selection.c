@@ -0,0 +1,48 @@
+/**
+ * @file selection.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>Selection</i></b> data type
+ */
+
+#include "selection.h"
+#include <stdlib.h>
+
+bool selectionCreate(Selection *selection, int size)
+{
+    int words = selectionWords(size);
+    selection->words = (uint64_t *)calloc(words > 0 ? words : 1, sizeof(uint64_t));
+    selection->size = size;
+    selection->count = 0;
+    return selection->words != NULL;
+}
+
+void selectionDestroy(Selection *selection)
+{
+    free(selection->words);
+    selection->words = NULL;
+    selection->size = 0;
+    selection->count = 0;
+}
+
+int selectionWords(int size)
+{
+    return (size + SELECTION_WORD_BITS - 1) / SELECTION_WORD_BITS;
+}
+
+bool selectionContains(const Selection *selection, int row)
+{
+    return selection == NULL || (selection->words[row / SELECTION_WORD_BITS] >> (row % SELECTION_WORD_BITS) & 1);
+}
+
+int selectionFirst(const Selection *selection, int size)
+{
+    if (selection == NULL)
+        return size > 0 ? 0 : -1;
+
+    for (int w = 0; w < selectionWords(size); w++)
+    {
+        if (selection->words[w] != 0)
+            return w * SELECTION_WORD_BITS + __builtin_ctzll(selection->words[w]);
+    }
+    return -1;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file selection.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>Selection</i></b> and related operations.
+ * <br>A selection is a set of rows of a patient store, kept as a bitmap: bit <b>i % 64</b> of word <b>i / 64</b> is set if row <b>i</b> is selected.
+ * Commands that accept a selection treat a NULL selection as every row.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** The number of rows in each word of a selection. */
+#define SELECTION_WORD_BITS 64
+
+/**
+ * @brief Represents a selection of rows.
+ * 
+ */
+typedef struct selection
+{
+    uint64_t *words; //Bits beyond the last row are never set
+    int size;        //The number of rows the selection was made from
+    int count;       //The number of rows selected
+} Selection;
+
+/**
+ * @brief Creates an empty selection over a number of rows.
+ * 
+ * @param selection [out] The selection
+ * @param size [in] The number of rows
+ * @return true if the selection was successfully created or,
+ * @return false if insufficient memory for allocation
+ */
+bool selectionCreate(Selection *selection, int size);
+
+/**
+ * @brief Frees the bitmap of a selection.
+ * 
+ * @param selection [in] The selection
+ */
+void selectionDestroy(Selection *selection);
+
+/**
+ * @brief Retrieves the number of words of the bitmap of a selection over a number of rows.
+ * 
+ * @param size [in] The number of rows
+ * @return The number of words
+ */
+int selectionWords(int size);
+
+/**
+ * @brief Checks if a row is selected.
+ * 
+ * @param selection [in] The selection, or NULL for every row
+ * @param row [in] The row
+ * @return true if the row is selected or,
+ * @return false otherwise
+ */
+bool selectionContains(const Selection *selection, int row);
+
+/**
+ * @brief Finds the first selected row.
+ * 
+ * @param selection [in] The selection, or NULL for every row
+ * @param size [in] The number of rows
+ * @return The first selected row, or
+ * @return -1 if no row is selected
+ */
+int selectionFirst(const Selection *selection, int size);
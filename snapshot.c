@@ -0,0 +1,615 @@
+/**
+ * @file snapshot.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to snapshots of the loaded patients and regions.
+ */
+
+#include "snapshot.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC "COVIDSNP"
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/** The number of rows gathered in memory before being written to each region column. */
+#define SNAPSHOT_BLOCK_ROWS 4096
+
+/**
+ * @brief Describes which field of a record is stored in a column.
+ * 
+ */
+typedef struct columnField
+{
+    size_t offset;
+    size_t size;
+} ColumnField;
+
+#define COLUMN_FIELD(type, member) {offsetof(type, member), sizeof(((type *)0)->member)}
+#define STORE_ELEMENT(member) sizeof(*((PatientStore *)0)->member)
+
+/** The fields of Region stored in each region column, in the order of enum snapshotColumnId. */
+static const ColumnField regionFields[] = {
+    COLUMN_FIELD(Region, name),
+    COLUMN_FIELD(Region, capital),
+    COLUMN_FIELD(Region, population),
+    COLUMN_FIELD(Region, area),
+};
+
+/** The size of the elements of each column, in the order of enum snapshotColumnId. The dictionary columns are made of bytes. */
+static const size_t columnElementSizes[SNAPSHOT_COLUMNS] = {
+    STORE_ELEMENT(ids),
+    STORE_ELEMENT(sexCodes),
+    STORE_ELEMENT(birthYears),
+    STORE_ELEMENT(countryCodes),
+    STORE_ELEMENT(regionCodes),
+    STORE_ELEMENT(infectionReasonCodes),
+    STORE_ELEMENT(infectedBy),
+    STORE_ELEMENT(confirmedDays),
+    STORE_ELEMENT(releasedDays),
+    STORE_ELEMENT(deceasedDays),
+    STORE_ELEMENT(statusCodes),
+    STORE_ELEMENT(regionIds),
+    sizeof(Patient),
+    STORE_ELEMENT(infections.parents),
+    STORE_ELEMENT(infections.childOffsets),
+    STORE_ELEMENT(infections.children),
+    STORE_ELEMENT(days.cumulative[DAILY_CONFIRMED]),
+    STORE_ELEMENT(days.cumulative[DAILY_RELEASED]),
+    STORE_ELEMENT(days.cumulative[DAILY_DECEASED]),
+    sizeof(((Region *)0)->name),
+    sizeof(((Region *)0)->capital),
+    sizeof(((Region *)0)->population),
+    sizeof(((Region *)0)->area),
+    1,
+    1,
+    1,
+    1,
+    1,
+};
+
+/** The number of dictionary columns, which follow the region columns. */
+#define DICTIONARY_COLUMNS (SNAPSHOT_COLUMNS - SNAPSHOT_SEXES)
+
+/**
+ * @brief Calculates the number of elements a column must have, from the header of its snapshot.
+ * 
+ * @param header [in] The header of the snapshot, whose numbers of patients and regions and number of days are set
+ * @param column [in] The column
+ * @return The number of elements of the column, or
+ * @return -1 if the column can have any number of elements: the infection children, as many as the last child offset, and the dictionaries
+ */
+static int64_t expectedCount(const SnapshotHeader *header, int column)
+{
+    if (column <= SNAPSHOT_INFECTION_PARENTS)
+        return header->numberOfPatients;
+    if (column == SNAPSHOT_INFECTION_CHILD_OFFSETS)
+        return header->numberOfPatients + 1;
+    if (column >= SNAPSHOT_DAILY_CONFIRMED && column <= SNAPSHOT_DAILY_DECEASED)
+        return (int64_t)header->dayCount + 1;
+    if (column >= SNAPSHOT_REGION_NAME && column <= SNAPSHOT_REGION_AREA)
+        return header->numberOfRegions;
+    return -1;
+}
+
+/**
+ * @brief Retrieves the arrays of a patient store stored in the columns that come before the region columns, in the order of enum snapshotColumnId.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param patients [in] The patients of the list the store was created from
+ * @param arrays [out] The arrays
+ */
+static void storeArrays(const PatientStore *store, const Patient *patients, const void *arrays[SNAPSHOT_REGION_NAME])
+{
+    arrays[SNAPSHOT_PATIENT_ID] = store->ids;
+    arrays[SNAPSHOT_PATIENT_SEX] = store->sexCodes;
+    arrays[SNAPSHOT_PATIENT_BIRTH_YEAR] = store->birthYears;
+    arrays[SNAPSHOT_PATIENT_COUNTRY] = store->countryCodes;
+    arrays[SNAPSHOT_PATIENT_REGION] = store->regionCodes;
+    arrays[SNAPSHOT_PATIENT_INFECTION_REASON] = store->infectionReasonCodes;
+    arrays[SNAPSHOT_PATIENT_INFECTED_BY] = store->infectedBy;
+    arrays[SNAPSHOT_PATIENT_CONFIRMED_DAY] = store->confirmedDays;
+    arrays[SNAPSHOT_PATIENT_RELEASED_DAY] = store->releasedDays;
+    arrays[SNAPSHOT_PATIENT_DECEASED_DAY] = store->deceasedDays;
+    arrays[SNAPSHOT_PATIENT_STATUS] = store->statusCodes;
+    arrays[SNAPSHOT_PATIENT_REGION_ID] = store->regionIds;
+    arrays[SNAPSHOT_PATIENTS] = patients;
+    arrays[SNAPSHOT_INFECTION_PARENTS] = store->infections.parents;
+    arrays[SNAPSHOT_INFECTION_CHILD_OFFSETS] = store->infections.childOffsets;
+    arrays[SNAPSHOT_INFECTION_CHILDREN] = store->infections.children;
+    arrays[SNAPSHOT_DAILY_CONFIRMED] = store->days.cumulative[DAILY_CONFIRMED];
+    arrays[SNAPSHOT_DAILY_RELEASED] = store->days.cumulative[DAILY_RELEASED];
+    arrays[SNAPSHOT_DAILY_DECEASED] = store->days.cumulative[DAILY_DECEASED];
+}
+
+/**
+ * @brief Retrieves the dictionaries of the patients in the order of the dictionary columns.
+ * 
+ * @param dictionaries [in] The dictionaries of the patients
+ * @param ordered [out] The dictionaries, from the one of SNAPSHOT_SEXES to the one of SNAPSHOT_STATUSES
+ */
+static void dictionaryColumns(const PatientDictionaries *dictionaries, PtDictionary ordered[DICTIONARY_COLUMNS])
+{
+    ordered[SNAPSHOT_SEXES - SNAPSHOT_SEXES] = dictionaries->sexes;
+    ordered[SNAPSHOT_COUNTRIES - SNAPSHOT_SEXES] = dictionaries->countries;
+    ordered[SNAPSHOT_REGIONS - SNAPSHOT_SEXES] = dictionaries->regions;
+    ordered[SNAPSHOT_INFECTION_REASONS - SNAPSHOT_SEXES] = dictionaries->infectionReasons;
+    ordered[SNAPSHOT_STATUSES - SNAPSHOT_SEXES] = dictionaries->statuses;
+}
+
+/**
+ * @brief Calculates the number of bytes the strings of a dictionary take in its column, terminators included.
+ * 
+ * @param dictionary [in] The dictionary, or NULL for none
+ * @return The number of bytes
+ */
+static uint64_t dictionaryColumnLength(PtDictionary dictionary)
+{
+    uint64_t length = 0;
+    for (int code = 0; code < dictionarySize(dictionary); code++)
+        length += strlen(dictionaryString(dictionary, code)) + 1;
+    return length;
+}
+
+/**
+ * @brief Writes the strings of a dictionary at the place of its column, in the order of their codes.
+ * 
+ * @param f [in] The snapshot file
+ * @param header [in] The header of the snapshot
+ * @param column [in] The dictionary column
+ * @param dictionary [in] The dictionary, or NULL for none
+ * @return true if the strings were successfully written or,
+ * @return false otherwise
+ */
+static bool writeDictionaryColumn(FILE *f, const SnapshotHeader *header, int column, PtDictionary dictionary)
+{
+    if (fseek(f, (long)header->columns[column].offset, SEEK_SET) != 0)
+        return false;
+    for (int code = 0; code < dictionarySize(dictionary); code++)
+    {
+        const char *text = dictionaryString(dictionary, code);
+        if (fwrite(text, 1, strlen(text) + 1, f) != strlen(text) + 1)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds the strings of a dictionary column to an empty dictionary, so that each string gets back the code it had when it was saved.
+ * 
+ * @param strings [in] The strings of the column
+ * @param length [in] The number of bytes of the column
+ * @param dictionary [in] The empty dictionary
+ * @return SNAPSHOT_OK if the strings were successfully added
+ * @return SNAPSHOT_INVALID_FORMAT if the last string is not terminated, or a string appears twice, so that codes would shift
+ * @return SNAPSHOT_NO_MEMORY if insufficient memory for allocation
+ */
+static int readDictionaryColumn(const char *strings, uint64_t length, PtDictionary dictionary)
+{
+    if (length > 0 && strings[length - 1] != '\0')
+        return SNAPSHOT_INVALID_FORMAT;
+
+    for (uint64_t position = 0; position < length;)
+    {
+        int textLength = strlen(strings + position);
+        int code = dictionaryIntern(dictionary, strings + position, textLength);
+        if (code == DICTIONARY_NO_MEMORY)
+            return SNAPSHOT_NO_MEMORY;
+        if (code != dictionarySize(dictionary) - 1)
+            return SNAPSHOT_INVALID_FORMAT;
+        position += textLength + 1;
+    }
+    return SNAPSHOT_OK;
+}
+
+/**
+ * @brief Checks that every value of a column read from a snapshot is in a range, e.g., that every code is in its dictionary.
+ * 
+ * @param values [in] The values of the column
+ * @param count [in] The number of values
+ * @param minimum [in] The lowest value allowed
+ * @param limit [in] The value right after the highest value allowed
+ * @return true if every value is in [minimum, limit[ or,
+ * @return false otherwise
+ */
+static bool valuesInRange(const int values[], int count, int minimum, int limit)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (values[i] < minimum || values[i] >= limit)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that the rows, codes and offsets of a mapped snapshot are in range, so that the store can index with them.
+ * <br>The patients as a whole are only printed, through the dictionaries, which tolerate any code, so they are not checked.
+ * 
+ * @param snapshot [in] The mapped snapshot
+ * @param dictionaries [in] The dictionaries read from the snapshot
+ * @return true if the snapshot can be used in place or,
+ * @return false otherwise
+ */
+static bool validContents(const Snapshot *snapshot, const PatientDictionaries *dictionaries)
+{
+    const SnapshotHeader *header = (const SnapshotHeader *)snapshot->file.contents;
+    int size = snapshot->numberOfPatients;
+
+    bool valid = valuesInRange(snapshot->sexCodes, size, 0, dictionarySize(dictionaries->sexes)) &&
+                 valuesInRange(snapshot->countryCodes, size, 0, dictionarySize(dictionaries->countries)) &&
+                 valuesInRange(snapshot->regionCodes, size, 0, dictionarySize(dictionaries->regions)) &&
+                 valuesInRange(snapshot->infectionReasonCodes, size, 0, dictionarySize(dictionaries->infectionReasons)) &&
+                 valuesInRange(snapshot->statusCodes, size, 0, dictionarySize(dictionaries->statuses)) &&
+                 valuesInRange(snapshot->regionIds, size, -1, snapshot->numberOfRegions) &&
+                 valuesInRange(snapshot->parents, size, -1, size) &&
+                 snapshot->childOffsets[0] == 0 &&
+                 (uint64_t)snapshot->childOffsets[size] == header->columns[SNAPSHOT_INFECTION_CHILDREN].count &&
+                 valuesInRange(snapshot->children, snapshot->childOffsets[size], 0, size);
+
+    for (int i = 0; valid && i < size; i++)
+        valid = snapshot->childOffsets[i] <= snapshot->childOffsets[i + 1];
+    return valid;
+}
+
+/**
+ * @brief Rounds an offset up to the alignment of the columns.
+ * 
+ * @param offset [in] An offset in the file
+ * @return The smallest aligned offset not lower than <b>offset</b>
+ */
+static uint64_t alignColumnOffset(uint64_t offset)
+{
+    return (offset + SNAPSHOT_COLUMN_ALIGNMENT - 1) / SNAPSHOT_COLUMN_ALIGNMENT * SNAPSHOT_COLUMN_ALIGNMENT;
+}
+
+/**
+ * @brief Writes an array at the place of its column, as it is.
+ * 
+ * @param f [in] The snapshot file
+ * @param header [in] The header of the snapshot
+ * @param column [in] The column to write
+ * @param values [in] The array, of as many elements as the column
+ * @return true if the column was successfully written or,
+ * @return false otherwise
+ */
+static bool writeColumn(FILE *f, const SnapshotHeader *header, int column, const void *values)
+{
+    SnapshotColumn stored = header->columns[column];
+    if (fseek(f, (long)stored.offset, SEEK_SET) != 0)
+        return false;
+    return fwrite(values, stored.elementSize, stored.count, f) == stored.count;
+}
+
+/**
+ * @brief Gathers one field of a block of regions into a column buffer and writes it at its place in the column.
+ * 
+ * @param f [in] The snapshot file
+ * @param header [in] The header of the snapshot
+ * @param column [in] The region column to write
+ * @param regions [in] The block of regions
+ * @param firstRow [in] The row of the first region of the block
+ * @param rows [in] The number of regions in the block
+ * @param buffer [in] A buffer large enough to hold the field of every region of the block
+ * @return true if the block was successfully written or,
+ * @return false otherwise
+ */
+static bool writeRegionColumnBlock(FILE *f, const SnapshotHeader *header, int column, const Region *regions, int firstRow, int rows, char *buffer)
+{
+    ColumnField field = regionFields[column - SNAPSHOT_REGION_NAME];
+    for (int i = 0; i < rows; i++)
+    {
+        memcpy(buffer + i * field.size, (const char *)&regions[i] + field.offset, field.size);
+    }
+    if (fseek(f, (long)(header->columns[column].offset + (uint64_t)firstRow * field.size), SEEK_SET) != 0)
+        return false;
+    return fwrite(buffer, field.size, rows, f) == (size_t)rows;
+}
+
+/**
+ * @brief Scatters one region column of a mapped snapshot into the matching field of a region. It is the reverse of writeRegionColumnBlock.
+ * 
+ * @param snapshot [in] The mapped snapshot
+ * @param column [in] The region column to read
+ * @param region [out] The region
+ * @param row [in] The row of the region
+ */
+static void readRegionColumn(const Snapshot *snapshot, int column, Region *region, int row)
+{
+    const SnapshotHeader *header = (const SnapshotHeader *)snapshot->file.contents;
+    ColumnField field = regionFields[column - SNAPSHOT_REGION_NAME];
+    memcpy((char *)region + field.offset, snapshot->file.contents + header->columns[column].offset + (uint64_t)row * field.size, field.size);
+}
+
+int snapshotSave(char *filename, PtList patientsList, PtPatientStore patientStore, PtMap regionsMap, Date mostRecentConfirmedDate)
+{
+    const Patient *patients = NULL;
+    int numberOfPatients = 0;
+    listSpan(patientsList, &patients, &numberOfPatients);
+    if (numberOfPatients > 0 && patientStore == NULL)
+        return SNAPSHOT_NO_MEMORY;
+
+    //Without patients, the arrays of an empty store are written: a single child offset and a single prefix sum per event, all 0.
+    static int noEvents[1] = {0};
+    PatientStore empty;
+    if (patientStore == NULL)
+    {
+        memset(&empty, 0, sizeof(empty));
+        empty.infections.childOffsets = noEvents;
+        empty.days.firstDay = 1;
+        for (int e = 0; e < DAILY_EVENTS; e++)
+            empty.days.cumulative[e] = noEvents;
+        patientStore = &empty;
+    }
+
+    //The regions are saved in the order of the region ids of the store, if it is linked to them.
+    MapValue *regions = NULL;
+    int numberOfRegions = 0;
+    if (patientStore->regionValues != NULL)
+    {
+        numberOfRegions = patientStore->regionCount;
+    }
+    else if (!mapIsEmpty(regionsMap))
+    {
+        regions = mapValues(regionsMap);
+        if (regions == NULL)
+            return SNAPSHOT_NO_MEMORY;
+        mapSize(regionsMap, &numberOfRegions);
+    }
+    const MapValue *savedRegions = regions != NULL ? regions : patientStore->regionValues;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.version = SNAPSHOT_VERSION;
+    header.numberOfPatients = numberOfPatients;
+    header.numberOfRegions = numberOfRegions;
+    header.mostRecentConfirmedDay = mostRecentConfirmedDate.day;
+    header.mostRecentConfirmedMonth = mostRecentConfirmedDate.month;
+    header.mostRecentConfirmedYear = mostRecentConfirmedDate.year;
+    header.firstDay = patientStore->days.firstDay;
+    header.dayCount = patientStore->days.dayCount;
+    header.patientsWithoutRegion = patientStore->patientsWithoutRegion;
+
+    PtDictionary ordered[DICTIONARY_COLUMNS];
+    dictionaryColumns(&patientStore->dictionaries, ordered);
+
+    uint64_t offset = sizeof(header);
+    for (int column = 0; column < SNAPSHOT_COLUMNS; column++)
+    {
+        int64_t count = expectedCount(&header, column);
+        if (column == SNAPSHOT_INFECTION_CHILDREN)
+            count = patientStore->infections.childOffsets[numberOfPatients];
+        else if (column >= SNAPSHOT_SEXES)
+            count = dictionaryColumnLength(ordered[column - SNAPSHOT_SEXES]);
+
+        header.columns[column].count = count;
+        header.columns[column].elementSize = columnElementSizes[column];
+        header.columns[column].offset = alignColumnOffset(offset);
+        offset = header.columns[column].offset + header.columns[column].count * header.columns[column].elementSize;
+    }
+
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL)
+    {
+        free(regions);
+        return SNAPSHOT_WRITE_ERROR;
+    }
+
+    char *buffer = (char *)malloc(SNAPSHOT_BLOCK_ROWS * sizeof(Region));
+    if (buffer == NULL)
+    {
+        free(regions);
+        fclose(f);
+        return SNAPSHOT_NO_MEMORY;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    //The arrays of the store are written as they are, since they already are columns.
+    const void *arrays[SNAPSHOT_REGION_NAME];
+    storeArrays(patientStore, patients, arrays);
+    for (int column = 0; ok && column < SNAPSHOT_REGION_NAME; column++)
+    {
+        ok = writeColumn(f, &header, column, arrays[column]);
+    }
+    for (int firstRow = 0; ok && firstRow < numberOfRegions; firstRow += SNAPSHOT_BLOCK_ROWS)
+    {
+        int rows = numberOfRegions - firstRow < SNAPSHOT_BLOCK_ROWS ? numberOfRegions - firstRow : SNAPSHOT_BLOCK_ROWS;
+        for (int column = SNAPSHOT_REGION_NAME; ok && column < SNAPSHOT_SEXES; column++)
+        {
+            ok = writeRegionColumnBlock(f, &header, column, savedRegions + firstRow, firstRow, rows, buffer);
+        }
+    }
+    for (int column = SNAPSHOT_SEXES; ok && column < SNAPSHOT_COLUMNS; column++)
+    {
+        ok = writeDictionaryColumn(f, &header, column, ordered[column - SNAPSHOT_SEXES]);
+    }
+
+    //Empty columns at the end still lie within the file, so the file is padded up to the end of the last one.
+    long end = ok && fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    for (ok = end >= 0; ok && (uint64_t)end < offset; end++)
+    {
+        ok = fputc('\0', f) != EOF;
+    }
+
+    free(buffer);
+    free(regions);
+    if (fclose(f) != 0)
+        ok = false;
+
+    return ok ? SNAPSHOT_OK : SNAPSHOT_WRITE_ERROR;
+}
+
+int snapshotMap(char *filename, Snapshot *snapshot)
+{
+    if (!mappedFileOpen(filename, &snapshot->file))
+        return SNAPSHOT_FILE_NOT_FOUND;
+
+    const SnapshotHeader *header = (const SnapshotHeader *)snapshot->file.contents;
+    bool valid = snapshot->file.size >= sizeof(SnapshotHeader) &&
+                 memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->byteOrder == SNAPSHOT_BYTE_ORDER &&
+                 header->version == SNAPSHOT_VERSION &&
+                 header->numberOfPatients < INT32_MAX &&
+                 header->numberOfRegions <= INT32_MAX &&
+                 header->dayCount >= 0 && header->dayCount < INT32_MAX &&
+                 header->patientsWithoutRegion <= header->numberOfPatients;
+
+    for (int column = 0; valid && column < SNAPSHOT_COLUMNS; column++)
+    {
+        SnapshotColumn stored = header->columns[column];
+        int64_t count = expectedCount(header, column);
+        valid = stored.elementSize == columnElementSizes[column] &&
+                (count == -1 || stored.count == (uint64_t)count) &&
+                stored.offset % SNAPSHOT_COLUMN_ALIGNMENT == 0 &&
+                stored.offset >= sizeof(SnapshotHeader) &&
+                stored.offset <= snapshot->file.size &&
+                stored.count <= (snapshot->file.size - stored.offset) / stored.elementSize;
+    }
+
+    if (!valid)
+    {
+        mappedFileClose(&snapshot->file);
+        return SNAPSHOT_INVALID_FORMAT;
+    }
+
+    const char *contents = snapshot->file.contents;
+    snapshot->numberOfPatients = (int)header->numberOfPatients;
+    snapshot->numberOfRegions = (int)header->numberOfRegions;
+    snapshot->mostRecentConfirmedDate = dateCreate(header->mostRecentConfirmedDay, header->mostRecentConfirmedMonth, header->mostRecentConfirmedYear);
+
+    snapshot->ids = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_ID].offset);
+    snapshot->sexCodes = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_SEX].offset);
+    snapshot->birthYears = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_BIRTH_YEAR].offset);
+    snapshot->countryCodes = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_COUNTRY].offset);
+    snapshot->regionCodes = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_REGION].offset);
+    snapshot->infectionReasonCodes = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_INFECTION_REASON].offset);
+    snapshot->infectedBy = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_INFECTED_BY].offset);
+    snapshot->confirmedDays = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_CONFIRMED_DAY].offset);
+    snapshot->releasedDays = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_RELEASED_DAY].offset);
+    snapshot->deceasedDays = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_DECEASED_DAY].offset);
+    snapshot->statusCodes = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_STATUS].offset);
+    snapshot->regionIds = (const void *)(contents + header->columns[SNAPSHOT_PATIENT_REGION_ID].offset);
+    snapshot->patientsWithoutRegion = (int)header->patientsWithoutRegion;
+    snapshot->patients = (const void *)(contents + header->columns[SNAPSHOT_PATIENTS].offset);
+    snapshot->parents = (const void *)(contents + header->columns[SNAPSHOT_INFECTION_PARENTS].offset);
+    snapshot->childOffsets = (const void *)(contents + header->columns[SNAPSHOT_INFECTION_CHILD_OFFSETS].offset);
+    snapshot->children = (const void *)(contents + header->columns[SNAPSHOT_INFECTION_CHILDREN].offset);
+    snapshot->firstDay = header->firstDay;
+    snapshot->dayCount = header->dayCount;
+    snapshot->cumulative[DAILY_CONFIRMED] = (const void *)(contents + header->columns[SNAPSHOT_DAILY_CONFIRMED].offset);
+    snapshot->cumulative[DAILY_RELEASED] = (const void *)(contents + header->columns[SNAPSHOT_DAILY_RELEASED].offset);
+    snapshot->cumulative[DAILY_DECEASED] = (const void *)(contents + header->columns[SNAPSHOT_DAILY_DECEASED].offset);
+    snapshot->regionNames = (const void *)(contents + header->columns[SNAPSHOT_REGION_NAME].offset);
+    snapshot->regionCapitals = (const void *)(contents + header->columns[SNAPSHOT_REGION_CAPITAL].offset);
+    snapshot->regionPopulations = (const void *)(contents + header->columns[SNAPSHOT_REGION_POPULATION].offset);
+    snapshot->regionAreas = (const void *)(contents + header->columns[SNAPSHOT_REGION_AREA].offset);
+    for (int column = SNAPSHOT_SEXES; column < SNAPSHOT_COLUMNS; column++)
+    {
+        snapshot->dictionaryStrings[column - SNAPSHOT_SEXES] = contents + header->columns[column].offset;
+        snapshot->dictionaryLengths[column - SNAPSHOT_SEXES] = header->columns[column].count;
+    }
+
+    return SNAPSHOT_OK;
+}
+
+void snapshotUnmap(Snapshot *snapshot)
+{
+    mappedFileClose(&snapshot->file);
+}
+
+int snapshotOpen(char *filename, PtList *patientsList, PtPatientStore *patientStore, PtMap *regionsMap, int *numberOfPatients, int *numberOfRegions,
+                 Date *mostRecentConfirmedDate)
+{
+    Snapshot snapshot;
+    int error_code = snapshotMap(filename, &snapshot);
+    if (error_code != SNAPSHOT_OK)
+        return error_code;
+
+    //The store is laid over the mapped columns: only the dictionaries and the regions, both small, are read into memory.
+    PatientStore columns;
+    memset(&columns, 0, sizeof(columns));
+    PtMap map = mapCreate(snapshot.numberOfRegions > 0 ? snapshot.numberOfRegions : 1);
+    columns.regionValues = snapshot.numberOfRegions > 0 ? (MapValue *)malloc(snapshot.numberOfRegions * sizeof(MapValue)) : NULL;
+    bool created = patientDictionariesCreate(&columns.dictionaries) && map != NULL && (snapshot.numberOfRegions == 0 || columns.regionValues != NULL);
+    error_code = created ? SNAPSHOT_OK : SNAPSHOT_NO_MEMORY;
+
+    //The dictionaries come first, so that the codes of the patients can be checked against them.
+    PtDictionary ordered[DICTIONARY_COLUMNS];
+    dictionaryColumns(&columns.dictionaries, ordered);
+    for (int d = 0; error_code == SNAPSHOT_OK && d < DICTIONARY_COLUMNS; d++)
+    {
+        error_code = readDictionaryColumn(snapshot.dictionaryStrings[d], snapshot.dictionaryLengths[d], ordered[d]);
+    }
+
+    //Never trust the rows and codes read from a file: the store indexes arrays with them.
+    if (error_code == SNAPSHOT_OK && !validContents(&snapshot, &columns.dictionaries))
+        error_code = SNAPSHOT_INVALID_FORMAT;
+
+    if (error_code != SNAPSHOT_OK)
+    {
+        free(columns.regionValues);
+        patientDictionariesDestroy(&columns.dictionaries);
+        mapDestroy(&map);
+        snapshotUnmap(&snapshot);
+        return error_code;
+    }
+
+    //The regions keep the order they were saved in, which is the order of the region ids of the patients.
+    for (int i = 0; i < snapshot.numberOfRegions; i++)
+    {
+        Region *region = &columns.regionValues[i];
+        for (int column = SNAPSHOT_REGION_NAME; column < SNAPSHOT_SEXES; column++)
+        {
+            readRegionColumn(&snapshot, column, region, i);
+        }
+        region->name[sizeof(region->name) - 1] = '\0';
+        region->capital[sizeof(region->capital) - 1] = '\0';
+        mapPut(map, mapKeyCreate(region->name), *region);
+    }
+
+    columns.size = snapshot.numberOfPatients;
+    columns.ids = (long int *)snapshot.ids;
+    columns.birthYears = (int *)snapshot.birthYears;
+    columns.infectedBy = (long int *)snapshot.infectedBy;
+    columns.confirmedDays = (int *)snapshot.confirmedDays;
+    columns.releasedDays = (int *)snapshot.releasedDays;
+    columns.deceasedDays = (int *)snapshot.deceasedDays;
+    columns.sexCodes = (int *)snapshot.sexCodes;
+    columns.countryCodes = (int *)snapshot.countryCodes;
+    columns.regionCodes = (int *)snapshot.regionCodes;
+    columns.infectionReasonCodes = (int *)snapshot.infectionReasonCodes;
+    columns.statusCodes = (int *)snapshot.statusCodes;
+    columns.regionIds = (int *)snapshot.regionIds;
+    columns.regionCount = snapshot.numberOfRegions;
+    columns.patientsWithoutRegion = snapshot.patientsWithoutRegion;
+    columns.infections.size = snapshot.numberOfPatients;
+    columns.infections.parents = (int *)snapshot.parents;
+    columns.infections.childOffsets = (int *)snapshot.childOffsets;
+    columns.infections.children = (int *)snapshot.children;
+    columns.days.firstDay = snapshot.firstDay;
+    columns.days.dayCount = snapshot.dayCount;
+    for (int e = 0; e < DAILY_EVENTS; e++)
+        columns.days.cumulative[e] = (int *)snapshot.cumulative[e];
+
+    //From here on, the store owns the mapping, and the list shares the patients of the mapping with it.
+    PtPatientStore store = patientStoreCreateMapped(&columns, &snapshot.file);
+    PtList list = store != NULL ? listCreateShared(snapshot.patients, snapshot.numberOfPatients) : NULL;
+    if (list == NULL)
+    {
+        patientStoreDestroy(&store);
+        mapDestroy(&map);
+        return SNAPSHOT_NO_MEMORY;
+    }
+
+    *patientsList = list;
+    *patientStore = store;
+    *regionsMap = map;
+    *numberOfPatients = snapshot.numberOfPatients;
+    *numberOfRegions = snapshot.numberOfRegions;
+    *mostRecentConfirmedDate = snapshot.mostRecentConfirmedDate;
+    return SNAPSHOT_OK;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file snapshot.h
+ * @author Pedro Vitória
+ * @brief Defines the binary snapshot format used to save and reopen the loaded patients and regions, and related operations.
+ * <br>A snapshot stores the columns of the patient store, its infection graph, its daily series and the fields of the regions as separate, aligned columns
+ * of fixed-size elements, so a snapshot can be memory-mapped and its columns used in place (see snapshotMap), without being read into memory first.
+ * The string fields of the patients are stored as their codes, and the strings of each of their dictionaries as one more column,
+ * one null-terminated string after the other, in the order of their codes. The patients are also stored whole, for the list of patients.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "list.h"
+#include "map.h"
+#include "patientStore.h"
+#include "mappedFile.h"
+
+#define SNAPSHOT_OK 0
+#define SNAPSHOT_FILE_NOT_FOUND 1
+#define SNAPSHOT_INVALID_FORMAT 2
+#define SNAPSHOT_WRITE_ERROR 3
+#define SNAPSHOT_NO_MEMORY 4
+
+/** The version of the snapshot format. Must be incremented whenever the layout of the file or of a column changes. */
+#define SNAPSHOT_VERSION 4
+
+/** The alignment, in bytes, of the beginning of each column in the file. */
+#define SNAPSHOT_COLUMN_ALIGNMENT 64
+
+/**
+ * @brief Identifies each column of a snapshot.
+ * 
+ */
+enum snapshotColumnId
+{
+    SNAPSHOT_PATIENT_ID,
+    SNAPSHOT_PATIENT_SEX,
+    SNAPSHOT_PATIENT_BIRTH_YEAR,
+    SNAPSHOT_PATIENT_COUNTRY,
+    SNAPSHOT_PATIENT_REGION,
+    SNAPSHOT_PATIENT_INFECTION_REASON,
+    SNAPSHOT_PATIENT_INFECTED_BY,
+    SNAPSHOT_PATIENT_CONFIRMED_DAY,
+    SNAPSHOT_PATIENT_RELEASED_DAY,
+    SNAPSHOT_PATIENT_DECEASED_DAY,
+    SNAPSHOT_PATIENT_STATUS,
+    SNAPSHOT_PATIENT_REGION_ID,
+    SNAPSHOT_PATIENTS,
+    SNAPSHOT_INFECTION_PARENTS,
+    SNAPSHOT_INFECTION_CHILD_OFFSETS,
+    SNAPSHOT_INFECTION_CHILDREN,
+    SNAPSHOT_DAILY_CONFIRMED,
+    SNAPSHOT_DAILY_RELEASED,
+    SNAPSHOT_DAILY_DECEASED,
+    SNAPSHOT_REGION_NAME,
+    SNAPSHOT_REGION_CAPITAL,
+    SNAPSHOT_REGION_POPULATION,
+    SNAPSHOT_REGION_AREA,
+    SNAPSHOT_SEXES,
+    SNAPSHOT_COUNTRIES,
+    SNAPSHOT_REGIONS,
+    SNAPSHOT_INFECTION_REASONS,
+    SNAPSHOT_STATUSES,
+    SNAPSHOT_COLUMNS
+};
+
+/**
+ * @brief Describes where a column is stored in a snapshot file.
+ * 
+ */
+typedef struct snapshotColumn
+{
+    uint64_t offset;
+    uint64_t elementSize;
+    uint64_t count; //The number of elements, e.g., the number of patients, or the number of bytes of the strings of a dictionary
+} SnapshotColumn;
+
+/**
+ * @brief Represents the header at the beginning of a snapshot file.
+ * 
+ */
+typedef struct snapshotHeader
+{
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint64_t numberOfPatients;
+    uint64_t numberOfRegions;
+    uint32_t mostRecentConfirmedDay;
+    uint32_t mostRecentConfirmedMonth;
+    uint32_t mostRecentConfirmedYear;
+    uint32_t reserved;
+    int32_t firstDay; //Those of the daily series
+    int32_t dayCount;
+    uint64_t patientsWithoutRegion;
+    SnapshotColumn columns[SNAPSHOT_COLUMNS];
+} SnapshotHeader;
+
+/**
+ * @brief Represents a snapshot mapped into memory. Each column points straight into the mapping.
+ * 
+ */
+typedef struct snapshot
+{
+    MappedFile file;
+    int numberOfPatients;
+    int numberOfRegions;
+    Date mostRecentConfirmedDate;
+
+    const long int *ids;
+    const int *sexCodes;
+    const int *birthYears;
+    const int *countryCodes;
+    const int *regionCodes;
+    const int *infectionReasonCodes;
+    const long int *infectedBy;
+    const int *confirmedDays;
+    const int *releasedDays;
+    const int *deceasedDays;
+    const int *statusCodes;
+    const int *regionIds;
+    int patientsWithoutRegion;
+    const Patient *patients;
+
+    const int *parents;
+    const int *childOffsets;
+    const int *children;
+
+    int firstDay;
+    int dayCount;
+    const int *cumulative[DAILY_EVENTS];
+
+    const char (*regionNames)[sizeof(((Region *)0)->name)];
+    const char (*regionCapitals)[sizeof(((Region *)0)->capital)];
+    const int *regionPopulations;
+    const float *regionAreas;
+
+    const char *dictionaryStrings[SNAPSHOT_COLUMNS - SNAPSHOT_SEXES]; //In the order of the dictionary columns
+    uint64_t dictionaryLengths[SNAPSHOT_COLUMNS - SNAPSHOT_SEXES];
+} Snapshot;
+
+/**
+ * @brief Writes a snapshot of the loaded patients and regions to a file.
+ * 
+ * @param filename [in] The name of the file
+ * @param patientsList [in] A list of patients, or NULL if no patients are loaded
+ * @param patientStore [in] The columnar store of the patients of the list, or NULL if no patients are loaded
+ * @param regionsMap [in] A map of regions, or NULL if no regions are loaded
+ * @param mostRecentConfirmedDate [in] The most recent confirmed date of COVID-19 contamination
+ * @return SNAPSHOT_OK if the snapshot is successfully written
+ * @return SNAPSHOT_WRITE_ERROR if the file could not be created or written
+ * @return SNAPSHOT_NO_MEMORY if insufficient memory for allocation, or if there are patients but no store of them
+ */
+int snapshotSave(char *filename, PtList patientsList, PtPatientStore patientStore, PtMap regionsMap, Date mostRecentConfirmedDate);
+
+/**
+ * @brief Maps a snapshot file into memory and validates its layout, without reading its columns.
+ * 
+ * @param filename [in] The name of the file
+ * @param snapshot [out] The mapped snapshot. It must be released with snapshotUnmap
+ * @return SNAPSHOT_OK if the snapshot is successfully mapped
+ * @return SNAPSHOT_FILE_NOT_FOUND if the file could not be opened
+ * @return SNAPSHOT_INVALID_FORMAT if the file is not a snapshot, was written by a different version or on an incompatible platform
+ */
+int snapshotMap(char *filename, Snapshot *snapshot);
+
+/**
+ * @brief Releases a snapshot previously mapped with snapshotMap.
+ * 
+ * @param snapshot [in] The mapped snapshot
+ */
+void snapshotUnmap(Snapshot *snapshot);
+
+/**
+ * @brief Opens a snapshot file, creating a new list of patients, patient store and map of regions with its contents.
+ * <br>The columns are not read: the store uses them straight from the mapped file (see patientStoreCreateMapped), and the list shares the mapped patients
+ * (see listCreateShared), so opening takes time proportional to the number of patients only to check that the rows and codes in the columns are in range.
+ * The mapping is owned by the store, so the list must be destroyed before the store.
+ * 
+ * @param filename [in] The name of the file
+ * @param patientsList [out] The newly created list of patients
+ * @param patientStore [out] The newly created store of the patients, already linked to the regions
+ * @param regionsMap [out] The newly created map of regions
+ * @param numberOfPatients [out] The number of patients read from the snapshot
+ * @param numberOfRegions [out] The number of regions read from the snapshot
+ * @param mostRecentConfirmedDate [out] The most recent confirmed date of COVID-19 contamination
+ * @return SNAPSHOT_OK if the snapshot is successfully opened
+ * @return SNAPSHOT_FILE_NOT_FOUND if the file could not be opened
+ * @return SNAPSHOT_INVALID_FORMAT if the file is not a valid snapshot, e.g., if a patient has a code that is not in its dictionary
+ * @return SNAPSHOT_NO_MEMORY if insufficient memory for allocation
+ */
+int snapshotOpen(char *filename, PtList *patientsList, PtPatientStore *patientStore, PtMap *regionsMap, int *numberOfPatients, int *numberOfRegions,
+                 Date *mostRecentConfirmedDate);
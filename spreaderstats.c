@@ -0,0 +1,79 @@
+/**
+ * @file spreaderstats.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>SpreaderStats</i></b> data type
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "topK.h"
+#include "spreaderstats.h"
+
+SpreaderStats spreaderStatsCreate(long int patientID, int directInfections, int totalInfections, int rank)
+{
+    SpreaderStats stats;
+    stats.patientID = patientID;
+    stats.directInfections = directInfections;
+    stats.totalInfections = totalInfections;
+    stats.rank = rank;
+    return stats;
+}
+
+void spreaderStatsPrint(SpreaderStats stats)
+{
+    printf("\nPatient ID: %ld\n", stats.patientID);
+    printf("Patients infected directly: %d\n", stats.directInfections);
+    printf("Patients infected in total: %d\n", stats.totalInfections);
+}
+
+int spreaderStatsCompare(SpreaderStats stats1, SpreaderStats stats2)
+{
+    if (stats1.totalInfections != stats2.totalInfections)
+        return stats1.totalInfections > stats2.totalInfections ? 1 : -1;
+    if (stats1.directInfections != stats2.directInfections)
+        return stats1.directInfections > stats2.directInfections ? 1 : -1;
+    if (stats1.rank != stats2.rank)
+        return stats1.rank < stats2.rank ? 1 : -1;
+    return 0;
+}
+
+/**
+ * @brief Compares two stats through spreaderStatsCompare, as the bounded heap of the selection expects.
+ * 
+ * @param stats1 [in] The stats of a patient
+ * @param stats2 [in] The stats of another patient
+ * @return The result of spreaderStatsCompare
+ */
+static int compareSpreaderStats(const void *stats1, const void *stats2)
+{
+    return spreaderStatsCompare(*(const SpreaderStats *)stats1, *(const SpreaderStats *)stats2);
+}
+
+int selectTopSpreaders(PtPatientStore store, int k, SpreaderStats best[])
+{
+    if (k <= 0)
+        return 0;
+
+    InfectionGraph *graph = &store->infections;
+    int *totals = (int *)malloc((store->size > 0 ? store->size : 1) * sizeof(int));
+    if (totals == NULL || !infectionGraphCountDescendants(graph, totals))
+    {
+        free(totals);
+        return -1;
+    }
+
+    TopK top;
+    topKInit(&top, best, sizeof(SpreaderStats), k, compareSpreaderStats);
+    for (int i = 0; i < store->size; i++)
+    {
+        if (totals[i] == 0)
+            continue;
+
+        int direct = graph->childOffsets[i + 1] - graph->childOffsets[i];
+        SpreaderStats stats = spreaderStatsCreate(store->ids[i], direct, totals[i], i);
+        topKOffer(&top, &stats);
+    }
+
+    free(totals);
+    return topKFinish(&top);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file spreaderstats.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>SpreaderStats</i></b> and related operations.
+ * This data type's main use is in helping with calculations related to the <b>SPREADERS</b> command.
+ */
+
+#pragma once
+#include "patientStore.h"
+
+/**
+ * @brief Represents an instance of SpreaderStats
+ * 
+ */
+typedef struct spreaderstats
+{
+    long int patientID;
+    int directInfections; //Patients infected by this patient
+    int totalInfections;  //Patients infected by this patient, directly or through others
+    int rank;             //The row of the patient in the patient store (and rank in the list of patients)
+
+} SpreaderStats;
+
+/**
+ * @brief Creates and returns a new instance of SpreaderStats.
+ * 
+ * @param patientID [in] The patient's ID
+ * @param directInfections [in] The number of patients infected by the patient
+ * @param totalInfections [in] The number of patients infected by the patient, directly or not
+ * @param rank [in] The row of the patient in the patient store
+ * @return The newly created instance
+ */
+SpreaderStats spreaderStatsCreate(long int patientID, int directInfections, int totalInfections, int rank);
+
+/**
+ * @brief Prints a textual representation of an instance of SpreaderStats
+ * 
+ * @param stats [in] The instance to be printed
+ */
+void spreaderStatsPrint(SpreaderStats stats);
+
+/**
+ * @brief Compares the stats of two patients by the order of the <b>SPREADERS</b> command:
+ * the most patients infected in total first, then the most patients infected directly first, then the first in the store first.
+ * 
+ * @param stats1 [in] The stats of a patient
+ * @param stats2 [in] The stats of another patient
+ * @return A positive value if stats1 comes before stats2,
+ * @return a negative value if stats1 comes after stats2, or
+ * @return 0 if both are the stats of the same row
+ */
+int spreaderStatsCompare(SpreaderStats stats1, SpreaderStats stats2);
+
+/**
+ * @brief Selects the K patients who infected the most others, in the order of spreaderStatsCompare.
+ * <br>The descendants of every patient are counted in one pass over the infection graph of the store, and the store is then scanned once,
+ * keeping the best K patients seen so far in a bounded heap (see topK.h), so it takes O(n log K) time.
+ * Only patients who infected someone are considered.
+ * 
+ * @param store [in] A columnar store of patients
+ * @param k [in] The number of patients to select
+ * @param best [out] An array of at least K elements, filled with the selected patients, best first
+ * @return The number of patients selected, which is less than K if there aren't enough patients who infected someone, or
+ * @return -1 if insufficient memory for allocation
+ */
+int selectTopSpreaders(PtPatientStore store, int k, SpreaderStats best[]);
@@ -0,0 +1,126 @@
+/**
+ * @file testCsvTokenizer.c
+ * @author Pedro Vitória
+ * @brief Checks that every scanner supported by the processor splits lines into the same fields as the scalar scanner,
+ * on a few hand-written lines and on random buffers of delimiters, line terminators and text.
+ */
+
+#include "csvTokenizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of random buffers tokenized. */
+#define RANDOM_BUFFERS 2000
+
+/** The maximum length of a random buffer, in bytes. */
+#define MAX_BUFFER_LENGTH 400
+
+/** The maximum number of fields stored per line. */
+#define MAX_FIELDS 12
+
+static const char *scannerNames[CSV_SCANNERS] = {"scalar", "SSE2", "AVX2"};
+static int failures = 0;
+
+/**
+ * @brief Tokenizes a buffer with a scanner and with the scalar scanner, line by line, and reports the first difference.
+ *
+ * @param scanner [in] The scanner checked
+ * @param buffer [in] The buffer
+ * @param length [in] The length of the buffer, in bytes
+ * @param maxFields [in] The number of fields stored per line
+ */
+static void compareScanners(int scanner, const char *buffer, int length, int maxFields)
+{
+    const char *end = buffer + length;
+    const char *expectedCursor = buffer, *cursor = buffer;
+    Field expectedFields[MAX_FIELDS], fields[MAX_FIELDS];
+    int expectedCount = 0, count = 0;
+
+    for (int line = 0; expectedCursor < end; line++)
+    {
+        expectedCursor = tokenizeLine(CSV_SCANNER_SCALAR, expectedCursor, end, ';', expectedFields, maxFields, &expectedCount);
+        cursor = tokenizeLine(scanner, cursor, end, ';', fields, maxFields, &count);
+
+        bool same = cursor == expectedCursor && count == expectedCount;
+        for (int i = 0; same && i < maxFields; i++)
+            same = fields[i].start == expectedFields[i].start && fields[i].length == expectedFields[i].length;
+
+        if (!same)
+        {
+            printf("FAIL: %s differs from scalar on line %d of \"%.*s\" (%d fields stored)\n", scannerNames[scanner], line, length, buffer, maxFields);
+            failures++;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Checks the fields of a single line tokenized with a scanner.
+ *
+ * @param scanner [in] The scanner checked
+ * @param line [in] The line, followed by the rest of the buffer
+ * @param maxFields [in] The number of fields stored
+ * @param expectedCount [in] The number of fields the line has
+ * @param expectedFields [in] The text of the stored fields
+ * @param expectedNext [in] The offset of the beginning of the next line
+ */
+static void checkLine(int scanner, const char *line, int maxFields, int expectedCount, const char *expectedFields[], int expectedNext)
+{
+    Field fields[MAX_FIELDS];
+    int count = 0;
+    const char *next = tokenizeLine(scanner, line, line + strlen(line), ';', fields, maxFields, &count);
+
+    bool same = count == expectedCount && next == line + expectedNext;
+    for (int i = 0; same && i < maxFields; i++)
+        same = fields[i].length == (int)strlen(expectedFields[i]) && strncmp(fields[i].start, expectedFields[i], fields[i].length) == 0;
+
+    if (!same)
+    {
+        printf("FAIL: %s tokenizes \"%s\" wrongly\n", scannerNames[scanner], line);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    srand(2020);
+
+    for (int scanner = CSV_SCANNER_SCALAR; scanner < CSV_SCANNERS; scanner++)
+    {
+        if (!csvScannerSupported(scanner))
+        {
+            printf("%s scanner not supported by this processor, skipped\n", scannerNames[scanner]);
+            continue;
+        }
+
+        //Missing fields are padded, extra fields are only counted, and "\r\n" is not part of the last field.
+        const char *padded[] = {"1", "male", "", ""};
+        checkLine(scanner, "1;male\nnext", 4, 2, padded, 7);
+        const char *truncated[] = {"a", "b"};
+        checkLine(scanner, "a;b;c;d\r\n", 2, 4, truncated, 9);
+        const char *empty[] = {"", ""};
+        checkLine(scanner, "\n", 2, 1, empty, 1);
+        const char *longLine[] = {"0123456789012345678901234567890123456789", "x", "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"};
+        checkLine(scanner, "0123456789012345678901234567890123456789;x;abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz\r\n", 3, 3, longLine, 97);
+
+        //Random buffers mix delimiters, terminators and text, so that they fall at every offset of a 16 or 32-byte block.
+        static const char alphabet[] = ";;;\n\r,/0123456789abcdefghij ";
+        char buffer[MAX_BUFFER_LENGTH];
+        for (int b = 0; b < RANDOM_BUFFERS; b++)
+        {
+            int length = rand() % MAX_BUFFER_LENGTH;
+            for (int i = 0; i < length; i++)
+                buffer[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+            compareScanners(scanner, buffer, length, 1 + rand() % MAX_FIELDS);
+        }
+    }
+
+    if (failures > 0)
+    {
+        printf("testCsvTokenizer: %d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("testCsvTokenizer: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file testInfectionGraph.c
+ * @author Pedro Vitória
+ * @brief Checks the traversals of the infection graph on a small graph built from a hand-written list of patients:
+ * a tree of four patients, and a loop of three patients with a branch of its own.
+ * <br>Rows 0 to 3 form the tree: 0 infected 1 and 2, and 1 infected 3.
+ * Rows 4 to 7 form the loop: 4 infected 5, 5 infected 6 and 7, and 6 infected 4. Row 8 was infected by an ID that is not in the data.
+ */
+
+#include "infectionGraph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of patients of the graph. */
+#define ROWS 9
+
+/** The ID of the patient of each row. */
+static const long int ids[ROWS] = {100, 101, 102, 103, 104, 105, 106, 107, 108};
+
+/** The ID of the infector of the patient of each row, or -1 if unknown. */
+static const long int infectedBy[ROWS] = {-1, 100, 100, 101, 106, 104, 105, 105, 999};
+
+static int failures = 0;
+
+/**
+ * @brief Checks that an array of rows holds the expected rows, in the same order.
+ *
+ * @param what [in] A description of the array, shown if it differs
+ * @param rows [in] The rows retrieved
+ * @param count [in] The number of rows retrieved
+ * @param expected [in] The rows expected
+ * @param expectedCount [in] The number of rows expected
+ */
+static void checkRows(const char *what, const int rows[], int count, const int expected[], int expectedCount)
+{
+    bool same = count == expectedCount;
+    for (int i = 0; same && i < count; i++)
+        same = rows[i] == expected[i];
+
+    if (!same)
+    {
+        printf("FAIL: %s:", what);
+        for (int i = 0; i < count; i++)
+            printf(" %d", rows[i]);
+        printf("\n");
+        failures++;
+    }
+}
+
+/**
+ * @brief Checks that a value is the expected one.
+ *
+ * @param what [in] A description of the value, shown if it differs
+ * @param value [in] The value computed
+ * @param expected [in] The value expected
+ */
+static void checkValue(const char *what, int value, int expected)
+{
+    if (value != expected)
+    {
+        printf("FAIL: %s is %d instead of %d\n", what, value, expected);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    PtList patientsList = listCreate(ROWS);
+    if (patientsList == NULL)
+    {
+        printf("FAIL: insufficient memory for the list\n");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < ROWS; i++)
+    {
+        Patient patient;
+        memset(&patient, 0, sizeof(patient));
+        patient.id = ids[i];
+        patient.infectedBy = infectedBy[i];
+        listAppend(patientsList, patient);
+    }
+
+    DatasetArena arena = {0};
+    InfectionGraph graph;
+    if (!infectionGraphBuild(&graph, patientsList, &arena))
+    {
+        printf("FAIL: insufficient memory for the graph\n");
+        return EXIT_FAILURE;
+    }
+
+    const int parents[ROWS] = {-1, 0, 0, 1, 6, 4, 5, 5, -1};
+    checkRows("parents", graph.parents, graph.size, parents, ROWS);
+
+    int rows[ROWS];
+    bool cycle = false;
+
+    //Descendants come in breadth-first order, and the loop doesn't bring back the patient the search started from.
+    const int treeDescendants[] = {1, 2, 3};
+    checkRows("descendants of row 0", rows, infectionGraphDescendants(&graph, 0, rows), treeDescendants, 3);
+    checkRows("descendants of row 3", rows, infectionGraphDescendants(&graph, 3, rows), NULL, 0);
+    const int loopDescendants[] = {5, 6, 7};
+    checkRows("descendants of row 4", rows, infectionGraphDescendants(&graph, 4, rows), loopDescendants, 3);
+    const int branchDescendants[] = {4, 5, 7};
+    checkRows("descendants of row 6", rows, infectionGraphDescendants(&graph, 6, rows), branchDescendants, 3);
+
+    //The depth stops at the first patient whose infector is unknown, or right before the walk would go around the loop again.
+    checkValue("depth of row 0", infectionGraphDepth(&graph, 0), 0);
+    checkValue("depth of row 3", infectionGraphDepth(&graph, 3), 2);
+    checkValue("depth of row 4", infectionGraphDepth(&graph, 4), 2);
+    checkValue("depth of row 7", infectionGraphDepth(&graph, 7), 3);
+    checkValue("depth of row 8", infectionGraphDepth(&graph, 8), 0);
+
+    const int treeChain[] = {3, 1, 0};
+    checkRows("chain of row 3", rows, infectionGraphChain(&graph, 3, rows, &cycle), treeChain, 3);
+    checkValue("cycle of the chain of row 3", cycle, false);
+    const int loopChain[] = {7, 5, 4, 6};
+    checkRows("chain of row 7", rows, infectionGraphChain(&graph, 7, rows, &cycle), loopChain, 4);
+    checkValue("cycle of the chain of row 7", cycle, true);
+
+    //Every patient of the loop infected the rest of the loop and its branch.
+    const int totals[ROWS] = {3, 1, 0, 0, 3, 3, 3, 0, 0};
+    if (!infectionGraphCountDescendants(&graph, rows))
+    {
+        printf("FAIL: insufficient memory to count the descendants\n");
+        failures++;
+    }
+    else
+    {
+        checkRows("descendant counts", rows, ROWS, totals, ROWS);
+    }
+
+    //A graph attached to the arrays of another one, as a mapped snapshot is, traverses the same rows.
+    InfectionGraph attached = {graph.size, graph.parents, graph.childOffsets, graph.children, NULL, 0};
+    if (!infectionGraphAttach(&attached, &arena))
+    {
+        printf("FAIL: insufficient memory to attach the graph\n");
+        failures++;
+    }
+    else
+    {
+        checkRows("descendants of row 6 of the attached graph", rows, infectionGraphDescendants(&attached, 6, rows), branchDescendants, 3);
+        checkValue("depth of row 7 of the attached graph", infectionGraphDepth(&attached, 7), 3);
+    }
+
+    datasetArenaRelease(&arena);
+    listDestroy(&patientsList);
+
+    if (failures > 0)
+    {
+        printf("testInfectionGraph: %d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("testInfectionGraph: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file testPatientStatsKernels.c
+ * @author Pedro Vitória
+ * @brief Checks that every statistics kernel supported by the processor accumulates the same statistics as the scalar kernel,
+ * on random columns and random ranges of rows, with and without a selection.
+ * <br>The columns include unknown birth years (-1), ages over 152, negative ages (birth years after 2020), and codes that are neither of the
+ * codes the kernels test for. Some stores also lack the male, female or status codes altogether (DICTIONARY_UNKNOWN).
+ */
+
+#include "patientStatsKernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/** The number of random stores generated. */
+#define RANDOM_STORES 200
+
+/** The number of random ranges checked on each store. */
+#define RANGES_PER_STORE 50
+
+/** The maximum number of rows of a random store. */
+#define MAX_ROWS 1000
+
+/** The number of codes of the sex and status columns; the codes the kernels test for are picked among them. */
+#define CODES 6
+
+static const char *kernelNames[STATS_KERNELS] = {"scalar", "AVX2"};
+static int failures = 0;
+
+/**
+ * @brief Picks the codes a store resolved for some values: distinct codes, as the values are distinct strings,
+ * each of them DICTIONARY_UNKNOWN once in a while, as if the value didn't occur in the data.
+ *
+ * @param codes [out] The codes, from 0 to CODES - 1, or DICTIONARY_UNKNOWN
+ * @param count [in] The number of codes, at most CODES
+ */
+static void randomResolvedCodes(int *codes[], int count)
+{
+    int permutation[CODES];
+    for (int i = 0; i < CODES; i++)
+        permutation[i] = i;
+    for (int i = CODES - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1), temp = permutation[i];
+        permutation[i] = permutation[j];
+        permutation[j] = temp;
+    }
+    for (int i = 0; i < count; i++)
+        *codes[i] = rand() % 10 == 0 ? DICTIONARY_UNKNOWN : permutation[i];
+}
+
+/**
+ * @brief Draws a random birth year: unknown, an age from 0 to 152, an age over 152, or a negative age.
+ *
+ * @return The birth year
+ */
+static int randomBirthYear(void)
+{
+    switch (rand() % 6)
+    {
+    case 0:
+        return -1;
+    case 1:
+        return 2020 - (153 + rand() % 100); //Over the last age band
+    case 2:
+        return 2020 + 1 + rand() % 30; //Negative age
+    default:
+        return 2020 - rand() % 153;
+    }
+}
+
+/**
+ * @brief Checks if two sets of statistics are identical.
+ *
+ * @param stats1 [in] The first statistics
+ * @param stats2 [in] The second statistics
+ * @return true if every count, sum and year is the same or,
+ * @return false otherwise
+ */
+static bool statsEqual(const PatientStats *stats1, const PatientStats *stats2)
+{
+    if (stats1->maleCount != stats2->maleCount || stats1->femaleCount != stats2->femaleCount || stats1->unknownSexCount != stats2->unknownSexCount ||
+        stats1->earliestMaleYear != stats2->earliestMaleYear || stats1->earliestFemaleYear != stats2->earliestFemaleYear)
+        return false;
+
+    for (int column = 0; column < STATUS_COLUMNS; column++)
+    {
+        if (stats1->agedCountByStatus[column] != stats2->agedCountByStatus[column] || stats1->ageSumByStatus[column] != stats2->ageSumByStatus[column])
+            return false;
+        for (int band = 0; band < AGE_BANDS; band++)
+        {
+            if (stats1->ageBandByStatus[band][column] != stats2->ageBandByStatus[band][column])
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Accumulates a range of rows with a kernel and with the scalar kernel, from the same starting statistics, and reports any difference.
+ *
+ * @param kernel [in] The kernel checked
+ * @param store [in] The store
+ * @param selection [in] The rows to include, or NULL for all
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ */
+static void compareKernels(int kernel, const PatientStore *store, const Selection *selection, int begin, int end)
+{
+    PatientStats expected, stats;
+    memset(&expected, 0, sizeof(expected));
+    expected.maleCount = rand() % 100; //Kernels add to the statistics they are given
+    expected.earliestMaleYear = rand() % 2 == 0 ? INT_MAX : 1900 + rand() % 150;
+    expected.earliestFemaleYear = rand() % 2 == 0 ? INT_MAX : 1900 + rand() % 150;
+    stats = expected;
+
+    accumulatePatientStatsWith(STATS_KERNEL_SCALAR, store, selection, begin, end, &expected);
+    accumulatePatientStatsWith(kernel, store, selection, begin, end, &stats);
+
+    if (!statsEqual(&expected, &stats))
+    {
+        printf("FAIL: %s differs from scalar on rows [%d, %d[ of %d, %s\n", kernelNames[kernel], begin, end, store->size,
+               selection != NULL ? "with a selection" : "without a selection");
+        failures++;
+    }
+}
+
+int main(void)
+{
+    srand(2020);
+
+    static int sexCodes[MAX_ROWS], birthYears[MAX_ROWS], statusCodes[MAX_ROWS];
+    PatientStore store;
+    memset(&store, 0, sizeof(store));
+    store.sexCodes = sexCodes;
+    store.birthYears = birthYears;
+    store.statusCodes = statusCodes;
+
+    for (int s = 0; s < RANDOM_STORES; s++)
+    {
+        store.size = rand() % (MAX_ROWS + 1);
+        int *sexes[] = {&store.maleCode, &store.femaleCode};
+        int *statuses[] = {&store.isolatedCode, &store.deceasedCode, &store.releasedCode};
+        randomResolvedCodes(sexes, 2);
+        randomResolvedCodes(statuses, 3);
+        for (int i = 0; i < store.size; i++)
+        {
+            sexCodes[i] = rand() % CODES;
+            birthYears[i] = randomBirthYear();
+            statusCodes[i] = rand() % CODES;
+        }
+
+        //Selections range from sparse to dense, so that blocks of 8 rows are empty, full and partly selected.
+        Selection selection;
+        if (!selectionCreate(&selection, store.size))
+        {
+            printf("FAIL: insufficient memory for a selection\n");
+            return EXIT_FAILURE;
+        }
+        int density = rand() % 101;
+        for (int i = 0; i < store.size; i++)
+        {
+            if (rand() % 100 < density)
+            {
+                selection.words[i / SELECTION_WORD_BITS] |= (uint64_t)1 << (i % SELECTION_WORD_BITS);
+                selection.count++;
+            }
+        }
+
+        for (int kernel = STATS_KERNEL_SCALAR + 1; kernel < STATS_KERNELS; kernel++)
+        {
+            if (!patientStatsKernelSupported(kernel))
+                continue;
+
+            compareKernels(kernel, &store, NULL, 0, store.size);
+            compareKernels(kernel, &store, &selection, 0, store.size);
+            for (int r = 0; r < RANGES_PER_STORE; r++)
+            {
+                int begin = store.size > 0 ? rand() % (store.size + 1) : 0;
+                int end = begin + rand() % (store.size - begin + 1);
+                compareKernels(kernel, &store, NULL, begin, end);
+                compareKernels(kernel, &store, &selection, begin, end);
+            }
+        }
+        selectionDestroy(&selection);
+    }
+
+    for (int kernel = STATS_KERNEL_SCALAR + 1; kernel < STATS_KERNELS; kernel++)
+    {
+        if (!patientStatsKernelSupported(kernel))
+            printf("%s kernel not supported by this processor, skipped\n", kernelNames[kernel]);
+    }
+
+    if (failures > 0)
+    {
+        printf("testPatientStatsKernels: %d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("testPatientStatsKernels: OK\n");
+    return EXIT_SUCCESS;
+}
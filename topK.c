@@ -0,0 +1,121 @@
+/**
+ * @file topK.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>TopK</i></b> data type
+ */
+
+#include <string.h>
+#include <stdbool.h>
+#include "topK.h"
+
+/**
+ * @brief Retrieves an element of a heap.
+ *
+ * @param topK [in] The heap
+ * @param position [in] The position of the element
+ * @return The address of the element
+ */
+static char *elementAt(const TopK *topK, int position)
+{
+    return topK->elements + (size_t)position * topK->elementSize;
+}
+
+/**
+ * @brief Swaps two elements of a heap, byte by byte, so that elements of any size can be swapped without a buffer.
+ *
+ * @param topK [in] The heap
+ * @param position1 [in] The position of an element
+ * @param position2 [in] The position of another element
+ */
+static void swapElements(TopK *topK, int position1, int position2)
+{
+    char *element1 = elementAt(topK, position1);
+    char *element2 = elementAt(topK, position2);
+    for (size_t i = 0; i < topK->elementSize; i++)
+    {
+        char temp = element1[i];
+        element1[i] = element2[i];
+        element2[i] = temp;
+    }
+}
+
+/**
+ * @brief Restores the heap order below a position of the first elements of a heap.
+ *
+ * @param topK [in] The heap
+ * @param size [in] The number of elements in the heap
+ * @param position [in] The position whose element may be out of order
+ */
+static void siftDown(TopK *topK, int size, int position)
+{
+    while (true)
+    {
+        int worst = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+
+        if (left < size && topK->compare(elementAt(topK, left), elementAt(topK, worst)) < 0)
+            worst = left;
+        if (right < size && topK->compare(elementAt(topK, right), elementAt(topK, worst)) < 0)
+            worst = right;
+        if (worst == position)
+            return;
+
+        swapElements(topK, position, worst);
+        position = worst;
+    }
+}
+
+/**
+ * @brief Restores the heap order above a position of a heap.
+ *
+ * @param topK [in] The heap
+ * @param position [in] The position whose element may be out of order
+ */
+static void siftUp(TopK *topK, int position)
+{
+    while (position > 0)
+    {
+        int parent = (position - 1) / 2;
+        if (topK->compare(elementAt(topK, position), elementAt(topK, parent)) >= 0)
+            return;
+
+        swapElements(topK, position, parent);
+        position = parent;
+    }
+}
+
+void topKInit(TopK *topK, void *elements, size_t elementSize, int capacity, TopKCompare compare)
+{
+    topK->elements = (char *)elements;
+    topK->elementSize = elementSize;
+    topK->capacity = capacity > 0 ? capacity : 0;
+    topK->size = 0;
+    topK->compare = compare;
+}
+
+void topKOffer(TopK *topK, const void *element)
+{
+    if (topK->size < topK->capacity)
+    {
+        memcpy(elementAt(topK, topK->size), element, topK->elementSize);
+        siftUp(topK, topK->size);
+        topK->size++;
+    }
+    else if (topK->size > 0 && topK->compare(element, elementAt(topK, 0)) > 0)
+    {
+        memcpy(elementAt(topK, 0), element, topK->elementSize);
+        siftDown(topK, topK->size, 0);
+    }
+}
+
+int topKFinish(TopK *topK)
+{
+    //Sort the heap in place, by repeatedly moving its worst element to the end.
+    for (int last = topK->size - 1; last > 0; last--)
+    {
+        swapElements(topK, 0, last);
+        siftDown(topK, last, 0);
+    }
+    return topK->size;
+}
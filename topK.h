@@ -0,0 +1,62 @@
+/**
+ * @file topK.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>TopK</i></b>, a bounded heap that keeps the best K elements offered to it, and related operations.
+ * <br>It selects the patients of the <b>TOP5</b> and <b>SPREADERS</b> commands: every element is offered once, in O(log K) time,
+ * and only K elements are ever kept, so selecting from n elements takes O(n log K) time and O(K) memory.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Compares two elements by the order they are selected in.
+ *
+ * @param element1 [in] An element
+ * @param element2 [in] Another element
+ * @return A positive value if element1 comes before element2,
+ * @return a negative value if element1 comes after element2, or
+ * @return 0 if they are equivalent
+ */
+typedef int (*TopKCompare)(const void *element1, const void *element2);
+
+/**
+ * @brief Represents a bounded heap over an array of elements supplied by the caller. Its root is the worst of the elements kept.
+ *
+ */
+typedef struct topK
+{
+    char *elements;
+    size_t elementSize;
+    int capacity; //K
+    int size;
+    TopKCompare compare;
+} TopK;
+
+/**
+ * @brief Initializes an empty bounded heap.
+ *
+ * @param topK [out] The heap
+ * @param elements [in] An array of at least <b>capacity</b> elements, which holds the heap
+ * @param elementSize [in] The size of each element
+ * @param capacity [in] The number of elements to keep (K)
+ * @param compare [in] The order the elements are selected in
+ */
+void topKInit(TopK *topK, void *elements, size_t elementSize, int capacity, TopKCompare compare);
+
+/**
+ * @brief Offers an element to a heap. It is kept if the heap isn't full or if it comes before the worst element kept, which it then replaces.
+ *
+ * @param topK [in] The heap
+ * @param element [in] The element, which is copied
+ */
+void topKOffer(TopK *topK, const void *element);
+
+/**
+ * @brief Sorts the elements kept by a heap in place, best first. The heap must not be offered any more elements afterwards.
+ *
+ * @param topK [in] The heap
+ * @return The number of elements kept, which is less than K if fewer were offered
+ */
+int topKFinish(TopK *topK);
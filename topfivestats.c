@@ -5,15 +5,16 @@
  */
 
 #include <stdio.h>
+#include "topK.h"
 #include "topfivestats.h"
-#include "patientUtils.h"
 
-TopFiveStats topFiveStatsCreate(int age, int daysWithIllness, long int patientID)
+TopFiveStats topFiveStatsCreate(int age, int daysWithIllness, long int patientID, int rank)
 {
     TopFiveStats stats;
     stats.age = age;
     stats.daysWithIllness = daysWithIllness;
     stats.patientID = patientID;
+    stats.rank = rank;
     return stats;
 }
 
@@ -32,52 +33,44 @@ void topFiveStatsPrint(TopFiveStats stats)
     printf("Number of days taken to recover: %d\n", stats.daysWithIllness);
 }
 
-void sortTopFiveByDaysToRecover(TopFiveStats arr[], int sizeArr)
+int topFiveStatsCompare(TopFiveStats stats1, TopFiveStats stats2)
 {
-    TopFiveStats temp;
-    for (int i = 0; i < sizeArr; i++)
-    {
-        for (int j = 0; j < sizeArr - i - 1; j++)
-        {
-            if (arr[j].daysWithIllness < arr[j + 1].daysWithIllness)
-            {
-                temp = arr[j];
-                arr[j] = arr[j + 1];
-                arr[j + 1] = temp;
-            }
-        }
-    }
+    if (stats1.daysWithIllness != stats2.daysWithIllness)
+        return stats1.daysWithIllness > stats2.daysWithIllness ? 1 : -1;
+    if (stats1.age != stats2.age)
+        return stats1.age > stats2.age ? 1 : -1;
+    if (stats1.rank != stats2.rank)
+        return stats1.rank < stats2.rank ? 1 : -1;
+    return 0;
 }
 
-void sortTopFiveByAgeTie(TopFiveStats arr[], int sizeArr)
+/**
+ * @brief Compares two stats through topFiveStatsCompare, as the bounded heap of the selection expects.
+ * 
+ * @param stats1 [in] The stats of a patient
+ * @param stats2 [in] The stats of another patient
+ * @return The result of topFiveStatsCompare
+ */
+static int compareTopFiveStats(const void *stats1, const void *stats2)
 {
-    TopFiveStats temp;
-    for (int i = 0; i < sizeArr; i++)
-    {
-        for (int j = 0; j < sizeArr - i - 1; j++)
-        {
-            if (arr[j].daysWithIllness == arr[j + 1].daysWithIllness && arr[j].age < arr[j + 1].age)
-            {
-                temp = arr[j + 1];
-                arr[j + 1] = arr[j];
-                arr[j] = temp;
-            }
-        }
-    }
+    return topFiveStatsCompare(*(const TopFiveStats *)stats1, *(const TopFiveStats *)stats2);
 }
 
-void fillTopFiveArray(PtList patientsList, TopFiveStats arr[], int sizeArr)
+int selectTopReleased(PtPatientStore store, const Selection *selection, int k, TopFiveStats best[])
 {
-    TopFiveStats patientStats;
-    for (int i = 0; i < sizeArr; i++)
-    {
-        ListElem patient;
-        listGet(patientsList, i, &patient);
+    if (k <= 0)
+        return 0;
 
-        int age = patient.birthYear != -1 ? 2020 - patient.birthYear : -1;
-        int daysWithIllness = getDifferenceBetweenDates(patient.confirmedDate, patient.releasedDate);
-        patientStats = topFiveStatsCreate(age, daysWithIllness, patient.id);
+    TopK top;
+    topKInit(&top, best, sizeof(TopFiveStats), k, compareTopFiveStats);
+    for (int i = 0; i < store->size; i++)
+    {
+        if (store->statusCodes[i] != store->releasedCode || store->releasedDays[i] == 0 || !selectionContains(selection, i))
+            continue;
 
-        arr[i] = patientStats;
+        int age = store->birthYears[i] != -1 ? 2020 - store->birthYears[i] : -1;
+        TopFiveStats stats = topFiveStatsCreate(age, store->releasedDays[i] - store->confirmedDays[i], store->ids[i], i);
+        topKOffer(&top, &stats);
     }
+    return topKFinish(&top);
 }
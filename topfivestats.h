@@ -7,6 +7,7 @@
 
 #pragma once
 #include "list.h"
+#include "patientStore.h"
 
 /**
  * @brief Represents an instance of TopFiveStats
@@ -17,6 +18,7 @@ typedef struct topfivestats
     int age;
     int daysWithIllness;
     long int patientID;
+    int rank; //The row of the patient in the patient store (and rank in the list of patients)
 
 } TopFiveStats;
 
@@ -26,9 +28,10 @@ typedef struct topfivestats
  * @param age [in] The age of the patient
  * @param daysWithIllness [in] The days it took the patient to recover. Also referred to as number of days with illness
  * @param patientID [in] The patient's ID
+ * @param rank [in] The row of the patient in the patient store
  * @return The newly created instance
  */
-TopFiveStats topFiveStatsCreate(int age, int daysWithIllness, long int patientID);
+TopFiveStats topFiveStatsCreate(int age, int daysWithIllness, long int patientID, int rank);
 
 /**
  * @brief Prints a textual representation of an instance of TopFiveStats
@@ -38,26 +41,26 @@ TopFiveStats topFiveStatsCreate(int age, int daysWithIllness, long int patientID
 void topFiveStatsPrint(TopFiveStats stats);
 
 /**
- * @brief Sorts the array of stats in descending order from highest days infected to lowest. (Also called number of days with illness)
+ * @brief Compares the stats of two patients by the order of the <b>TOP5</b> command:
+ * the most days taken to recover first, then the oldest first, then the first in the store first.
  * 
- * @param arr [in] The array to be sorted
- * @param sizeArr [in] The size of the array
+ * @param stats1 [in] The stats of a patient
+ * @param stats2 [in] The stats of another patient
+ * @return A positive value if stats1 comes before stats2,
+ * @return a negative value if stats1 comes after stats2, or
+ * @return 0 if both are the stats of the same row
  */
-void sortTopFiveByDaysToRecover(TopFiveStats arr[], int sizeArr);
+int topFiveStatsCompare(TopFiveStats stats1, TopFiveStats stats2);
 
 /**
- * @brief Sorts the array of stats by age if there's a tie between the patients' number of days with illness
+ * @brief Selects the K released patients who took the longest to recover, in the order of topFiveStatsCompare.
+ * <br>The store is scanned once, keeping the best K patients seen so far in a bounded heap (see topK.h), so it takes O(n log K) time and O(K) memory.
+ * Only released patients with a known release date are considered.
  * 
- * @param arr [in] The array to be sorted
- * @param sizeArr [in] The size of the array
+ * @param store [in] A columnar store of patients
+ * @param selection [in] The patients to consider, or NULL for all
+ * @param k [in] The number of patients to select
+ * @param best [out] An array of at least K elements, filled with the selected patients, best first
+ * @return The number of patients selected, which is less than K if there aren't enough released patients
  */
-void sortTopFiveByAgeTie(TopFiveStats arr[], int sizeArr);
-
-/**
- * @brief Fills an array with <b><i>TopFiveStats</i></b> instances where each instance represents stats of each patient in a list of patients
- * 
- * @param patientsList [in] A list of patients
- * @param arr [out] The array to be filled
- * @param sizeArr [in] The size of the array 
- */
-void fillTopFiveArray(PtList patientsList, TopFiveStats arr[], int sizeArr);
\ No newline at end of file
+int selectTopReleased(PtPatientStore store, const Selection *selection, int k, TopFiveStats best[]);
@@ -5,6 +5,8 @@
  */
 
 #include "utils.h"
+#include "fieldParsers.h"
+#include "workerPool.h"
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -20,7 +22,7 @@ char **split(char *string, int nFields, const char *delim)
 
     for (int i = 0; i < len; i++)
     {
-        if (string[i] == delim[0])
+        if (string[i] == delim[0] && index < nFields)
         {
             string[i] = '\0';
             if (i < len - 1)
@@ -32,6 +34,13 @@ char **split(char *string, int nFields, const char *delim)
     return tokens;
 }
 
+void copyField(Field field, char *destination, int destinationSize)
+{
+    int length = field.length < destinationSize - 1 ? field.length : destinationSize - 1;
+    memcpy(destination, field.start, length);
+    memset(destination + length, '\0', destinationSize - length); //Like strncpy, so that no stale bytes are saved in snapshots
+}
+
 bool isEmpty(char *str)
 {
     return strlen(str) == 0;
@@ -48,180 +57,188 @@ void replaceCharacter(char *str, char oldChar, char newChar)
     }
 }
 
-void fillMapOfRegionsStillInfected(PtList patientsList, PtMap regionsMap, PtMap mapOfRegionsStillInfected)
+/**
+ * @brief The context of the scans of the regions of the patients, for parallelReduce.
+ * 
+ */
+typedef struct regionScan
+{
+    PtPatientStore patientStore;
+    int regionCount;
+    int countryCode;
+} RegionScan;
+
+/**
+ * @brief Flags the regions of the isolated patients of a range of rows, for parallelReduce.
+ * 
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param partial [in] The flags (int[regionCount]) of the regions
+ * @param context [in] The scan (RegionScan *)
+ */
+static void flagRegionsStillInfected(int begin, int end, void *partial, void *context)
 {
-    int sizeList = 0;
-    listSize(patientsList, &sizeList);
+    PtPatientStore patientStore = ((RegionScan *)context)->patientStore;
+    int *flags = (int *)partial;
 
-    ListElem patient;
-    for (int i = 0; i < sizeList; i++)
+    for (int i = begin; i < end; i++)
     {
-        listGet(patientsList, i, &patient);
-        if ((strcmp(patient.status, "isolated") == 0)) //if isolated, put in the map
+        if (patientStore->statusCodes[i] == patientStore->isolatedCode && patientStore->regionIds[i] != -1)
         {
-            MapKey regionAsKey = mapKeyCreate(patient.region);
-            MapValue regionValue;
-            mapGet(regionsMap, regionAsKey, &regionValue);
-            mapPut(mapOfRegionsStillInfected, regionAsKey, regionValue);
+            flags[patientStore->regionIds[i]] = 1;
         }
-    } //Once this is done, we'll have our filtered map.
+    }
 }
 
-int countLeapYears(Date date)
+/**
+ * @brief Merges the flags of the regions of a range of rows, for parallelReduce.
+ * 
+ * @param result [in] The flags (int[regionCount]) of the regions of every row
+ * @param partial [in] The flags (const int[regionCount]) of the regions of the range
+ * @param context [in] The scan (RegionScan *)
+ */
+static void mergeRegionFlags(void *result, const void *partial, void *context)
 {
-    //Código tirado e adaptado de: https://www.geeksforgeeks.org/find-number-of-days-between-two-given-dates/
-    //Alterações feitas: Indentação e nomes das variáveis.
-    int years = date.year;
-    if (date.month <= 2)
+    int *flags = (int *)result;
+    const int *rangeFlags = (const int *)partial;
+
+    for (int id = 0; id < ((RegionScan *)context)->regionCount; id++)
     {
-        years--;
+        flags[id] |= rangeFlags[id];
     }
-
-    return years / 4 - years / 100 + years / 400;
 }
 
-int getDifferenceBetweenDates(Date date1, Date date2)
+int findRegionsStillInfected(PtPatientStore patientStore, int regionIds[])
 {
-    //Código tirado e adaptado de: https://www.geeksforgeeks.org/find-number-of-days-between-two-given-dates/
-    //Alterações feitas: Indentação e nomes das variáveis.
-    int monthDays[12] = {31, 28, 31, 30, 31, 30,
-                         31, 31, 30, 31, 30, 31};
-
-    long int n1 = date1.year * 365 + date1.day;
-
-    for (int i = 0; i < date1.month - 1; i++)
+    int regionCount = patientStore->regionCount;
+    for (int id = 0; id < regionCount; id++)
     {
-        n1 += monthDays[i];
+        regionIds[id] = 0;
     }
 
-    n1 += countLeapYears(date1);
+    //Flag the regions of the isolated patients, using the array itself for the flags.
+    RegionScan scan = {patientStore, regionCount, DICTIONARY_UNKNOWN};
+    parallelReduce(workerPoolShared(), patientStore->size, regionCount * sizeof(int), flagRegionsStillInfected, mergeRegionFlags, regionIds, &scan);
 
-    long int n2 = date2.year * 365 + date2.day;
-    for (int i = 0; i < date2.month - 1; i++)
+    //Then compact the flagged ids to the front, in increasing order.
+    int count = 0;
+    for (int id = 0; id < regionCount; id++)
     {
-        n2 += monthDays[i];
+        if (regionIds[id])
+        {
+            regionIds[count++] = id;
+        }
     }
+    return count;
+}
 
-    n2 += countLeapYears(date2);
-
-    return (n2 - n1);
+int getDifferenceBetweenDates(Date date1, Date date2)
+{
+    return date2.epochDay - date1.epochDay;
 }
 
 Date stringToDate(char *dateStr)
 {
-    Date date;
-
-    if (isEmpty(dateStr))
-    {
-        date.day = 0;
-        date.month = 0;
-        date.year = 0;
-    }
-    else
-    {
-        sscanf(dateStr, "%2d/%2d/%4d", &date.day, &date.month, &date.year);
-    }
-    return date;
+    return parseDate(dateStr, strlen(dateStr));
 }
 
 Date findMostRecentConfirmedDate(PtList patientsList)
 {
-    ListElem pt;
-    int maxDiff = 0;
-    Date helperMax = dateCreate(1, 1, 1111);
-    Date mostRecentDate;
+    const ListElem *pt;
+    Date mostRecentDate = dateCreate(1, 1, 1111);
 
-    int sizeList = 0;
-    listSize(patientsList, &sizeList);
-
-    for (int i = 0; i < sizeList; i++)
+    ListIterator patients = listIterate(patientsList);
+    while (listNext(&patients, &pt))
     {
-        listGet(patientsList, i, &pt);
-        int newDiff = getDifferenceBetweenDates(helperMax, pt.confirmedDate);
-        if (newDiff > maxDiff)
+        if (pt->confirmedDate.epochDay > mostRecentDate.epochDay)
         {
-            maxDiff = newDiff;
-            mostRecentDate = dateCreate(pt.confirmedDate.day, pt.confirmedDate.month, pt.confirmedDate.year);
+            mostRecentDate = pt->confirmedDate;
         }
     }
     return mostRecentDate;
 }
 
-bool calculateRegionStatistics(PtList patientsList, PtMap regionsMap, char *regionName, double *lethality, double *incidentRate, double *mortality, int sizeList, int sizeMap)
+/**
+ * @brief Counts the deaths and infections of a range of rows, for parallelReduce.
+ * <br>The counts of the regions are followed by the counts of the patients without a region and by the counts of the country.
+ * 
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param partial [in] The counts (OutcomeCounts[regionCount + 2])
+ * @param context [in] The scan (RegionScan *)
+ */
+static void countOutcomes(int begin, int end, void *partial, void *context)
 {
-    int population = 0;
-
-    MapValue region;
-    mapGet(regionsMap, mapKeyCreate(regionName), &region);
-    population = region.population;
+    RegionScan *scan = (RegionScan *)context;
+    PtPatientStore patientStore = scan->patientStore;
+    OutcomeCounts *regionCounts = (OutcomeCounts *)partial;
+    OutcomeCounts *withoutRegion = &regionCounts[scan->regionCount]; //Patients whose region isn't in the map are only counted in the country.
+    OutcomeCounts *countryTotals = &regionCounts[scan->regionCount + 1];
 
-    if (population <= 0)
+    for (int i = begin; i < end; i++)
     {
-        return false;
-    }
+        int regionId = patientStore->regionIds[i];
+        OutcomeCounts *counts = regionId != -1 ? &regionCounts[regionId] : withoutRegion;
+        bool inCountry = patientStore->countryCodes[i] == scan->countryCode;
 
-    int numberOfDeaths = 0;
-    int numberOfInfections = 0;
-    for (int i = 0; i < sizeList; i++)
-    {
-        ListElem patient;
-        listGet(patientsList, i, &patient);
-        if (strcmp(patient.region, regionName) == 0)
+        if (patientStore->statusCodes[i] == patientStore->deceasedCode)
         {
-            if (strcmp(patient.status, "deceased") == 0)
-            {
-                numberOfDeaths++;
-            }
-            else if (strcmp(patient.status, "isolated") == 0)
-            {
-                numberOfInfections++;
-            }
+            counts->deaths++;
+            countryTotals->deaths += inCountry;
+        }
+        else if (patientStore->statusCodes[i] == patientStore->isolatedCode)
+        {
+            counts->infections++;
+            countryTotals->infections += inCountry;
         }
     }
-
-    *lethality = ((double)numberOfDeaths / (double)sizeList) * 100;
-    *mortality = ((double)numberOfDeaths / (double)population) * 10000;
-    *incidentRate = ((double)numberOfInfections / (double)population) * 100;
-
-    return true;
 }
 
-bool calculateCountryStatistics(PtList patientsList, PtMap regionsMap, char *country, double *lethality, double *incidentRate, double *mortality, int sizeList, int sizeMap)
+/**
+ * @brief Merges the deaths and infections of a range of rows, for parallelReduce.
+ * 
+ * @param result [in] The counts (OutcomeCounts[regionCount + 2]) of every row
+ * @param partial [in] The counts (const OutcomeCounts[regionCount + 2]) of the range
+ * @param context [in] The scan (RegionScan *)
+ */
+static void mergeOutcomes(void *result, const void *partial, void *context)
 {
-    int populationOfKorea = 0;
+    OutcomeCounts *counts = (OutcomeCounts *)result;
+    const OutcomeCounts *rangeCounts = (const OutcomeCounts *)partial;
 
-    MapValue korea;
-    mapGet(regionsMap, mapKeyCreate("South Korea"), &korea);
-    populationOfKorea = korea.population;
+    for (int id = 0; id < ((RegionScan *)context)->regionCount + 2; id++)
+    {
+        counts[id].deaths += rangeCounts[id].deaths;
+        counts[id].infections += rangeCounts[id].infections;
+    }
+}
 
-    if (populationOfKorea <= 0)
+OutcomeCounts *countOutcomesByRegion(PtPatientStore patientStore, char *country, OutcomeCounts *countryCounts)
+{
+    int regionCount = patientStore->regionCount;
+    OutcomeCounts *regionCounts = (OutcomeCounts *)calloc(regionCount + 2, sizeof(OutcomeCounts));
+    if (regionCounts == NULL)
     {
-        return false;
+        return NULL;
     }
 
-    int countryDeaths = 0;
-    int countryInfections = 0;
+    RegionScan scan = {patientStore, regionCount, dictionaryFind(patientStore->dictionaries.countries, country)};
+    parallelReduce(workerPoolShared(), patientStore->size, (regionCount + 2) * sizeof(OutcomeCounts), countOutcomes, mergeOutcomes, regionCounts, &scan);
 
-    ListElem patient;
-    for (int i = 0; i < sizeList; i++)
+    *countryCounts = regionCounts[regionCount + 1];
+    return regionCounts;
+}
+
+bool calculateOutcomeStatistics(OutcomeCounts counts, int population, int sizeList, double *lethality, double *incidentRate, double *mortality)
+{
+    if (population <= 0)
     {
-        listGet(patientsList, i, &patient);
-        if (strcmp(patient.country, country) == 0)
-        {
-            if (strcmp(patient.status, "deceased") == 0)
-            {
-                countryDeaths++;
-            }
-            else if (strcmp(patient.status, "isolated") == 0)
-            {
-                countryInfections++;
-            }
-        }
+        return false;
     }
 
-    *lethality = ((double)countryDeaths / (double)sizeList) * 100;
-    *mortality = ((double)countryDeaths / (double)populationOfKorea) * 10000;
-    *incidentRate = ((double)countryInfections / (double)populationOfKorea) * 100;
+    *lethality = ((double)counts.deaths / (double)sizeList) * 100;
+    *mortality = ((double)counts.deaths / (double)population) * 10000;
+    *incidentRate = ((double)counts.infections / (double)population) * 100;
 
     return true;
 }
@@ -8,17 +8,29 @@
 
 #include "list.h"
 #include "map.h"
+#include "csvTokenizer.h"
+#include "patientStore.h"
 
 /**
  * @brief Splits a string into seperate pieces.
  * 
  * @param string [in] An array of characters
- * @param nFields [in] The number of fields to take in consideration in the splitting process
+ * @param nFields [in] The number of fields to take in consideration in the splitting process. Any fields beyond it are left unsplit in the last field
  * @param delim [in] A delimiter to determine how the splitting occurs in regards to field separation
  * @return An array of strings containing the split fields
  */
 char **split(char *string, int nFields, const char *delim);
 
+/**
+ * @brief Copies a field to a null-terminated string, truncating it if it doesn't fit.
+ * <br>The rest of <b>destination</b> is filled with null characters.
+ * 
+ * @param field [in] The field to copy
+ * @param destination [out] The string that will hold the field's contents
+ * @param destinationSize [in] The capacity of <b>destination</b>, including the null terminator
+ */
+void copyField(Field field, char *destination, int destinationSize);
+
 /**
  * @brief Checks if a given string is empty.
  * 
@@ -37,24 +49,18 @@ bool isEmpty(char *str);
 void replaceCharacter(char *str, char oldChar, char newChar);
 
 /**
- * @brief Fills a new instance of Map with the regions that still have active COVID-19 cases.
+ * @brief Finds the regions that still have active COVID-19 cases.
+ * <br>The patients are scanned by the threads of the shared worker pool (see parallelReduce).
  * 
- * @param patientsList [in] A list of patients
- * @param regionsMap [in] The map of all existing regions
- * @param mapOfRegionsStillInfected [out] The map that will only contain regions that still have active COVID-19 cases
+ * @param patientStore [in] A columnar store of patients, linked to the map of all existing regions (see patientStoreLinkRegions)
+ * @param regionIds [out] An array of at least <b>regionCount</b> elements, whose first elements will be the ids of the regions found, in increasing order
+ * @return The number of regions found
  */
-void fillMapOfRegionsStillInfected(PtList patientsList, PtMap regionsMap, PtMap mapOfRegionsStillInfected);
-
-/**
- * @brief Calculates the number of leap years before a given date.
- * 
- * @param date [in] The date
- * @return The number of leap years
- */
-int countLeapYears(Date date);
+int findRegionsStillInfected(PtPatientStore patientStore, int regionIds[]);
 
 /**
  * @brief Calculates the difference of days between two dates.
+ * <br>This is a single subtraction of the dates' epoch days.
  * 
  * @param date1 [in] The first date
  * @param date2 [in] The second date
@@ -79,46 +85,44 @@ Date stringToDate(char *dateStr);
 Date findMostRecentConfirmedDate(PtList patientsList);
 
 /**
- * @brief Calculates and returns by reference the following statistics for a region
- * <ul>
- * <li>Lethality
- * <li>Mortality rate
- * <li>Incident Rate of infection
- * </ul>
- * (Units for the statistics are given in percentages)<br>
- * This function also determines if the specified region has a populational number.
- * @param patientsList [in] A list of patients
- * @param regionsMap [in] A map of regions
- * @param regionName [in] The name of the region to perform the aforementioned calculations for
- * @param lethality [out] The lethality of the disease
- * @param incidentRate [out] The incident rate of infection
- * @param mortality [out] The mortality rate
- * @param sizeList [in] The number of patients in the list
- * @param sizeMap [in] The number of regions in the map
- * @return true if the region has a populational number or,
- * @return false if the region has no population
+ * @brief Represents the number of deaths and of infections (isolated patients) among a group of patients.
+ * 
  */
-bool calculateRegionStatistics(PtList patientsList, PtMap regionsMap, char *regionName, double *lethality, double *incidentRate, double *mortality, int sizeList, int sizeMap);
+typedef struct outcomeCounts
+{
+    int deaths;
+    int infections;
+} OutcomeCounts;
 
 /**
- * @brief Calculates and returns by reference the following country-related statistics
+ * @brief Counts the deaths and infections of every region and of a country, in a single scan of the patients split among the threads of the shared worker pool.
+ * <br>The counts of a region are found at the index of its region id.
+ * 
+ * @param patientStore [in] A columnar store of patients, linked to a map of regions (see patientStoreLinkRegions)
+ * @param country [in] The name of the country to count the deaths and infections of
+ * @param countryCounts [out] The deaths and infections of the country
+ * @return An array with the deaths and infections of each region, to be freed by the caller, or
+ * @return NULL if insufficient memory for allocation
+ */
+OutcomeCounts *countOutcomesByRegion(PtPatientStore patientStore, char *country, OutcomeCounts *countryCounts);
+
+/**
+ * @brief Calculates and returns by reference the following statistics for a region or a country
  * <ul>
  * <li>Lethality
  * <li>Mortality rate
  * <li>Incident Rate of infection
- * </ul> 
+ * </ul>
  * (Units for the statistics are given in percentages)<br>
- * This function also determines if the specified region has a populational number.
- * @param patientsList [in] A list of patients
- * @param regionsMap [in] A map of regions
- * @param country [in] The name of the country to perform the aforementioned calculations for
+ * This function also determines if the region or country has a populational number.
+ * @param counts [in] The deaths and infections of the region or country
+ * @param population [in] The population of the region or country
+ * @param sizeList [in] The number of patients in the store
  * @param lethality [out] The lethality of the disease
  * @param incidentRate [out] The incident rate of infection
  * @param mortality [out] The mortality rate
- * @param sizeList [in] The number of patients in the list
- * @param sizeMap [in] The number of regions in the map
- * @return true if the country has a populational number or,
- * @return false if the country has no population
+ * @return true if the region or country has a populational number or,
+ * @return false if it has no population
  */
-bool calculateCountryStatistics(PtList patientsList, PtMap regionsMap, char *country, double *lethality, double *incidentRate, double *mortality, int sizeList, int sizeMap);
+bool calculateOutcomeStatistics(OutcomeCounts counts, int population, int sizeList, double *lethality, double *incidentRate, double *mortality);
 
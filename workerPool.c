@@ -0,0 +1,262 @@
+/**
+ * @file workerPool.c
+ * @author Pedro Vitória
+ * @brief Provides implementations for all operations related to the <b><i>WorkerPool</i></b> data type
+ */
+
+#include "workerPool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief Represents a worker pool.
+ * <br>A single job (a set of tasks) runs at a time. The fields of the job are guarded by 'lock'.
+ *
+ */
+typedef struct workerPoolImpl
+{
+    pthread_mutex_t lock;
+    pthread_cond_t workAvailable; //Signaled when a job starts or the pool stops
+    pthread_cond_t workDone;      //Signaled when the last task of a job finishes
+
+    pthread_t workers[WORKER_POOL_MAX_THREADS];
+    int workerCount;
+    bool stopping;
+
+    WorkerTask task;
+    void *context;
+    int taskCount;
+    int nextTask;     //The next task to hand out
+    int pendingTasks; //Tasks not finished yet
+} WorkerPoolImpl;
+
+/** The pool shared by the commands, created on first use. */
+static PtWorkerPool sharedPool = NULL;
+
+/**
+ * @brief Runs the tasks of the current job of a pool until none is left to hand out. Must be called with the lock held, and returns with it held.
+ *
+ * @param pool [in] The pool
+ */
+static void runPendingTasks(PtWorkerPool pool)
+{
+    while (pool->nextTask < pool->taskCount)
+    {
+        int task = pool->nextTask++;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->task(task, pool->context);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pendingTasks == 0)
+            pthread_cond_broadcast(&pool->workDone);
+    }
+}
+
+/**
+ * @brief Entry point of the worker threads, which run tasks as jobs come in, until the pool stops.
+ *
+ * @param arg [in] The pool (PtWorkerPool)
+ * @return NULL
+ */
+static void *workerLoop(void *arg)
+{
+    PtWorkerPool pool = (PtWorkerPool)arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopping)
+    {
+        if (pool->nextTask < pool->taskCount)
+            runPendingTasks(pool);
+        else
+            pthread_cond_wait(&pool->workAvailable, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+PtWorkerPool workerPoolCreate(int numberOfThreads)
+{
+    if (numberOfThreads <= 0)
+        numberOfThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numberOfThreads > WORKER_POOL_MAX_THREADS)
+        numberOfThreads = WORKER_POOL_MAX_THREADS;
+
+    PtWorkerPool pool = (PtWorkerPool)calloc(1, sizeof(WorkerPoolImpl));
+    if (pool == NULL)
+        return NULL;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->workDone, NULL);
+
+    //The calling thread is one of the threads of the pool. Workers that fail to start are simply left out.
+    for (int i = 0; i < numberOfThreads - 1; i++)
+    {
+        if (pthread_create(&pool->workers[pool->workerCount], NULL, workerLoop, pool) == 0)
+            pool->workerCount++;
+    }
+    return pool;
+}
+
+void workerPoolDestroy(PtWorkerPool *ptPool)
+{
+    PtWorkerPool pool = *ptPool;
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->workerCount; i++)
+        pthread_join(pool->workers[i], NULL);
+
+    pthread_cond_destroy(&pool->workDone);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+
+    *ptPool = NULL;
+}
+
+int workerPoolThreads(PtWorkerPool pool)
+{
+    return pool != NULL ? pool->workerCount + 1 : 1;
+}
+
+PtWorkerPool workerPoolShared(void)
+{
+    if (sharedPool == NULL)
+        sharedPool = workerPoolCreate(0);
+    return sharedPool;
+}
+
+void workerPoolSharedDestroy(void)
+{
+    workerPoolDestroy(&sharedPool);
+}
+
+void workerPoolRun(PtWorkerPool pool, int taskCount, WorkerTask task, void *context)
+{
+    if (pool == NULL || pool->workerCount == 0 || taskCount <= 1)
+    {
+        for (int i = 0; i < taskCount; i++)
+            task(i, context);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->taskCount = taskCount;
+    pool->nextTask = 0;
+    pool->pendingTasks = taskCount;
+    pthread_cond_broadcast(&pool->workAvailable);
+
+    runPendingTasks(pool);
+    while (pool->pendingTasks > 0)
+        pthread_cond_wait(&pool->workDone, &pool->lock);
+
+    pool->taskCount = 0;
+    pool->nextTask = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Finds the number of tasks a range of rows is split into, which only depends on the number of rows.
+ *
+ * @param size [in] The number of rows
+ * @return The number of tasks, at least 1
+ */
+static int numberOfTasks(int size)
+{
+    int tasks = (size + MIN_ROWS_PER_TASK - 1) / MIN_ROWS_PER_TASK;
+    if (tasks > MAX_PARALLEL_TASKS)
+        tasks = MAX_PARALLEL_TASKS;
+    return tasks < 1 ? 1 : tasks;
+}
+
+/**
+ * @brief Finds the first row of a task of a range of rows. The rows are split as evenly as possible.
+ *
+ * @param size [in] The number of rows
+ * @param tasks [in] The number of tasks
+ * @param task [in] The task, or the number of tasks for the end of the last task
+ * @return The first row of the task
+ */
+static int taskBegin(int size, int tasks, int task)
+{
+    return (int)((long long)size * task / tasks);
+}
+
+/**
+ * @brief The context of the tasks of parallelFor and parallelReduce.
+ *
+ */
+typedef struct rangeJob
+{
+    int size;
+    int tasks;
+    RangeFunction function;
+    RangeReducer reduce;
+    char *partials; //One partial result per task, partialSize bytes apart
+    size_t partialSize;
+    void *context;
+} RangeJob;
+
+/**
+ * @brief Runs the function of a parallelFor over the rows of a task.
+ *
+ * @param task [in] The task
+ * @param arg [in] The job (RangeJob *)
+ */
+static void forTask(int task, void *arg)
+{
+    RangeJob *job = (RangeJob *)arg;
+    job->function(taskBegin(job->size, job->tasks, task), taskBegin(job->size, job->tasks, task + 1), job->context);
+}
+
+/**
+ * @brief Runs the reducer of a parallelReduce over the rows of a task, into the partial result of the task.
+ *
+ * @param task [in] The task
+ * @param arg [in] The job (RangeJob *)
+ */
+static void reduceTask(int task, void *arg)
+{
+    RangeJob *job = (RangeJob *)arg;
+    job->reduce(taskBegin(job->size, job->tasks, task), taskBegin(job->size, job->tasks, task + 1),
+                job->partials + task * job->partialSize, job->context);
+}
+
+void parallelFor(PtWorkerPool pool, int size, RangeFunction function, void *context)
+{
+    RangeJob job = {size, numberOfTasks(size), function, NULL, NULL, 0, context};
+    workerPoolRun(pool, job.tasks, forTask, &job);
+}
+
+void parallelReduce(PtWorkerPool pool, int size, size_t partialSize, RangeReducer reduce, PartialMerger merge, void *result, void *context)
+{
+    RangeJob job = {size, numberOfTasks(size), NULL, reduce, NULL, partialSize, context};
+
+    //A single task needs no partial results. Several tasks keep theirs even on a single thread, so that the result doesn't depend on the number of threads.
+    if (job.tasks == 1 || (job.partials = (char *)malloc(job.tasks * partialSize)) == NULL)
+    {
+        reduce(0, size, result, context);
+        return;
+    }
+
+    for (int i = 0; i < job.tasks; i++)
+        memcpy(job.partials + i * partialSize, result, partialSize);
+
+    workerPoolRun(pool, job.tasks, reduceTask, &job);
+
+    for (int i = 0; i < job.tasks; i++)
+        merge(result, job.partials + i * partialSize, context);
+
+    free(job.partials);
+}
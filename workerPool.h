@@ -0,0 +1,141 @@
+/**
+ * @file workerPool.h
+ * @author Pedro Vitória
+ * @brief Defines the data type <b><i>WorkerPool</i></b> and related operations.
+ * <br>A worker pool keeps a set of threads alive between commands, so that a scan over the patients can be split among them without creating threads each time.
+ * On top of the pool, parallelFor and parallelReduce split a range of rows into tasks of consecutive rows.
+ * The number and bounds of the tasks only depend on the number of rows, and partial results are merged in task order,
+ * so a command gives the same results whatever the number of threads.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** The maximum number of threads of a worker pool. */
+#define WORKER_POOL_MAX_THREADS 64
+
+/** The minimum number of rows that justifies an additional task. Smaller ranges are scanned by the calling thread alone. */
+#define MIN_ROWS_PER_TASK (1 << 14)
+
+/** The maximum number of tasks a range of rows is split into. */
+#define MAX_PARALLEL_TASKS 256
+
+/** Forward declaration of the data structure. */
+struct workerPoolImpl;
+
+/** Definition of pointer to the data structure. */
+typedef struct workerPoolImpl *PtWorkerPool;
+
+/**
+ * @brief Function run by a task of a worker pool.
+ *
+ * @param task [in] The index of the task, from 0 to the number of tasks - 1
+ * @param context [in] The context given to workerPoolRun
+ */
+typedef void (*WorkerTask)(int task, void *context);
+
+/**
+ * @brief Function that scans a range of rows.
+ *
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param context [in] The context given to parallelFor
+ */
+typedef void (*RangeFunction)(int begin, int end, void *context);
+
+/**
+ * @brief Function that accumulates a range of rows into a partial result.
+ *
+ * @param begin [in] The first row of the range
+ * @param end [in] The row right after the last row of the range
+ * @param partial [in] The partial result of the range, which starts as a copy of the initial result
+ * @param context [in] The context given to parallelReduce
+ */
+typedef void (*RangeReducer)(int begin, int end, void *partial, void *context);
+
+/**
+ * @brief Function that merges a partial result into the result.
+ *
+ * @param result [in] The result
+ * @param partial [in] The partial result of a range
+ * @param context [in] The context given to parallelReduce
+ */
+typedef void (*PartialMerger)(void *result, const void *partial, void *context);
+
+/**
+ * @brief Creates a new worker pool. The calling thread also runs tasks, so a pool of N threads starts N - 1 workers.
+ *
+ * @param numberOfThreads [in] The number of threads, or 0 for one per core. At most WORKER_POOL_MAX_THREADS
+ * @return PtWorkerPool pointer to the newly created pool, or
+ * @return NULL if insufficient memory for allocation
+ */
+PtWorkerPool workerPoolCreate(int numberOfThreads);
+
+/**
+ * @brief Stops the workers of a pool and frees it.
+ *
+ * @param ptPool [in] The address of the pointer to the pool, which is set to NULL
+ */
+void workerPoolDestroy(PtWorkerPool *ptPool);
+
+/**
+ * @brief Retrieves the number of threads of a pool, counting the calling thread.
+ *
+ * @param pool [in] The pool, or NULL
+ * @return The number of threads, 1 if the pool is NULL
+ */
+int workerPoolThreads(PtWorkerPool pool);
+
+/**
+ * @brief Retrieves the pool shared by the commands, with one thread per core. The pool is created on first use.
+ *
+ * @return The shared pool, or
+ * @return NULL if it couldn't be created, in which case the commands run on the calling thread alone
+ */
+PtWorkerPool workerPoolShared(void);
+
+/**
+ * @brief Destroys the pool shared by the commands, if it was created.
+ *
+ */
+void workerPoolSharedDestroy(void);
+
+/**
+ * @brief Runs a number of tasks on the threads of a pool, including the calling thread, and waits for all of them to finish.
+ * <br>Tasks are handed out in increasing order, to whichever thread is free.
+ *
+ * @param pool [in] The pool. If NULL, the calling thread runs every task
+ * @param taskCount [in] The number of tasks
+ * @param task [in] The function run by each task
+ * @param context [in] The context given to each task
+ */
+void workerPoolRun(PtWorkerPool pool, int taskCount, WorkerTask task, void *context);
+
+/**
+ * @brief Scans a range of rows, split into tasks of consecutive rows that run on the threads of a pool.
+ * <br>The tasks must only write to memory that belongs to their own rows.
+ *
+ * @param pool [in] The pool, or NULL to scan on the calling thread
+ * @param size [in] The number of rows, which are scanned from 0 to size - 1
+ * @param function [in] The function that scans each range
+ * @param context [in] The context given to the function
+ */
+void parallelFor(PtWorkerPool pool, int size, RangeFunction function, void *context);
+
+/**
+ * @brief Reduces a range of rows to a result, split into tasks of consecutive rows that run on the threads of a pool.
+ * <br>Each task accumulates its rows into its own copy of the initial result, and the copies are then merged into the result in task order.
+ * The initial result must be the identity of the merge (e.g., zeroed counts), and merging a copy into it must give the copy.
+ * If there is no memory for the copies, the rows are reduced straight into the result, on the calling thread.
+ *
+ * @param pool [in] The pool, or NULL to reduce on the calling thread
+ * @param size [in] The number of rows, which are reduced from 0 to size - 1
+ * @param partialSize [in] The size, in bytes, of the result
+ * @param reduce [in] The function that accumulates each range into a partial result
+ * @param merge [in] The function that merges each partial result into the result
+ * @param result [in] The result, holding the initial result on entry
+ * @param context [in] The context given to both functions
+ */
+void parallelReduce(PtWorkerPool pool, int size, size_t partialSize, RangeReducer reduce, PartialMerger merge, void *result, void *context);